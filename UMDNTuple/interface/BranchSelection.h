@@ -0,0 +1,32 @@
+#ifndef BRANCHSELECTION_H
+#define BRANCHSELECTION_H
+#include <vector>
+#include <string>
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+// Selection of branches from the keep and drop lists of branch name
+// globs of a parameter set.  A branch is selected if it matches any
+// keep pattern (all branches without keep) and no drop pattern.
+// Selections can be merged, the merged selection keeps a branch
+// that any of its parts keeps.  An empty selection keeps everything
+class BranchSelection {
+
+    public :
+        BranchSelection();
+        explicit BranchSelection( const edm::ParameterSet & );
+
+        void merge( const BranchSelection & );
+
+        bool selected( const std::string &name ) const;
+
+    private :
+
+        struct Rule {
+            std::vector<std::string> keep;
+            std::vector<std::string> drop;
+        };
+
+        std::vector<Rule> _rules;
+
+};
+#endif
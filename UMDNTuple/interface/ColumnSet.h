@@ -0,0 +1,115 @@
+#ifndef COLUMNSET_H
+#define COLUMNSET_H
+#include <vector>
+#include <string>
+#include "TTree.h"
+#include "UMDNTuple/UMDNTuple/interface/BranchSelection.h"
+
+// The per object columns of one collection, <prefix>_pt,
+// <prefix>_eta, ... and their counter <prefix>_n.
+//
+// Each column is declared once with add(), which books the branch
+// when the detail level is reached.  clear() empties all columns,
+// reserve() makes room for a collection and endObject() counts the
+// object and pads every booked column that was not filled for it
+// with the column default, so all columns have <prefix>_n entries.
+// Columns below the detail level or not selected by the keep and
+// drop lists are not booked, their vectors are only cleared.  The
+// producers check booked() to skip computing their values.
+// permute() reorders the objects of all booked columns
+class ColumnSet {
+
+    public :
+        ColumnSet();
+        ~ColumnSet();
+
+        // books the <prefix>_n counter
+        void initialize( const std::string &prefix, TTree *tree, int detail=99,
+                         const BranchSelection &selection=BranchSelection() );
+
+        // returns the vector to fill for <prefix>_<name>, owned by the set
+        template<class T>
+        std::vector<T> * add( const std::string &name, int detail=0, T def=T() );
+
+        // true if the vector returned by add is written
+        bool booked( const void *values ) const;
+
+        void clear();
+        void reserve( size_t n );
+        void endObject();
+        // object i becomes the object order[i] before the call
+        void permute( const std::vector<unsigned> &order );
+
+        int size() const { return _n; }
+        const std::string & prefix() const { return _prefix; }
+
+    private :
+
+        ColumnSet( const ColumnSet & );
+        ColumnSet & operator=( const ColumnSet & );
+
+        struct ColumnBase {
+            virtual ~ColumnBase() {}
+            virtual void clear() = 0;
+            virtual void reserve( size_t n ) = 0;
+            // returns false if the column has more than n entries
+            virtual bool pad( size_t n ) = 0;
+            virtual void permute( const std::vector<unsigned> &order ) = 0;
+            virtual const void * address() const = 0;
+            std::string name;
+        };
+
+        template<class T>
+        struct Column : public ColumnBase {
+            std::vector<T> *values;
+            // holds the previous buffer after a permutation
+            std::vector<T> scratch;
+            T def;
+            Column() : values( new std::vector<T>() ) {}
+            ~Column() { delete values; }
+            void clear() { values->clear(); }
+            void reserve( size_t n ) { values->reserve( n ); }
+            bool pad( size_t n ) {
+                if( values->size() > n ) return false;
+                values->resize( n, def );
+                return true;
+            }
+            void permute( const std::vector<unsigned> &order ) {
+                scratch.clear();
+                for( std::vector<unsigned>::const_iterator itr = order.begin();
+                        itr != order.end(); ++itr ) {
+                    scratch.push_back( (*values)[*itr] );
+                }
+                values->swap( scratch );
+            }
+            const void * address() const { return values; }
+        };
+
+        std::string _prefix;
+        TTree *_tree;
+        int _detail;
+        BranchSelection _selection;
+        int _n;
+
+        std::vector<ColumnBase*> _columns;
+        std::vector<ColumnBase*> _unbooked;
+
+};
+
+template<class T>
+std::vector<T> * ColumnSet::add( const std::string &name, int detail, T def ) {
+
+    Column<T> *col = new Column<T>();
+    col->name = _prefix + "_" + name;
+    col->def = def;
+
+    if( detail > _detail || !_selection.selected( col->name ) ) {
+        _unbooked.push_back( col );
+        return col->values;
+    }
+
+    _tree->Branch( col->name.c_str(), &col->values );
+    _columns.push_back( col );
+    return col->values;
+}
+#endif
@@ -0,0 +1,36 @@
+#ifndef CONVERSIONINDEX_H
+#define CONVERSIONINDEX_H
+#include <vector>
+#include <utility>
+#include "DataFormats/Provenance/interface/ProductID.h"
+#include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
+#include "DataFormats/EgammaCandidates/interface/ConversionFwd.h"
+#include "DataFormats/Math/interface/Point3D.h"
+
+// Tracks of the conversions that pass the selection of
+// ConversionTools::hasMatchedConversion.  build() is called once per
+// event, each electron is then looked up by its gsf and closest ctf
+// track instead of looping over all conversions.
+// matched() gives the same result as hasMatchedConversion with its
+// default arguments
+class ConversionIndex {
+
+    public :
+        ConversionIndex();
+
+        void build( const reco::ConversionCollection &conversions,
+                    const math::XYZPoint &beamspot );
+
+        bool matched( const reco::GsfElectron &ele ) const;
+
+    private :
+
+        typedef std::pair<edm::ProductID, size_t> TrackKey;
+
+        bool contains( const edm::ProductID &id, size_t key ) const;
+
+        // sorted, without duplicates
+        std::vector<TrackKey> _tracks;
+
+};
+#endif
@@ -0,0 +1,77 @@
+#ifndef EGAMMAKERNELS_H
+#define EGAMMAKERNELS_H
+#include <vector>
+#include <utility>
+#include "DataFormats/Candidate/interface/Candidate.h"
+
+// Batch computations of the electron and photon producers.  The
+// inputs of all objects of an event are collected first, in one array
+// per quantity, and compute() then loops over the arrays without
+// branches or calls into the objects
+
+// Kinematics after scaling the four momentum to a calibrated energy.
+// The scale does not change the direction, so eta and phi are those
+// of the object and only pt and energy are multiplied.  Scales that
+// are not positive are computed from the scaled four momentum
+class CalibratedKinematics {
+
+    public :
+        void clear();
+        void reserve( unsigned n );
+
+        void add( const reco::Candidate &cand, double calibratedEnergy );
+        void compute();
+
+        float pt( unsigned i )  const { return _ptOut[i]; }
+        float eta( unsigned i ) const { return _etaOut[i]; }
+        float phi( unsigned i ) const { return _phiOut[i]; }
+        float e( unsigned i )   const { return _eOut[i]; }
+
+        // object indices by decreasing calibrated pt, objects
+        // with the same pt keep their order.  Returns false
+        // if the objects are already in this order
+        bool ptOrder( std::vector<unsigned> &order ) const;
+
+    private :
+
+        std::vector<double> _pt;
+        std::vector<double> _eta;
+        std::vector<double> _phi;
+        std::vector<double> _e;
+        std::vector<double> _scale;
+        // four momenta of the objects with scales that are not positive
+        std::vector<std::pair<unsigned, reco::Candidate::LorentzVector> > _scaledP4;
+
+        std::vector<double> _ptOut;
+        std::vector<double> _etaOut;
+        std::vector<double> _phiOut;
+        std::vector<double> _eOut;
+
+};
+
+// Isolation sums corrected for pileup, max(0, iso - rho*area).
+// Each object has nIso sums, in the order of the areas of its
+// EffectiveAreaTable
+class CorrectedIsolation {
+
+    public :
+        explicit CorrectedIsolation( unsigned nIso=1 );
+
+        void clear();
+        void reserve( unsigned n );
+
+        void add( const float *iso );
+        // areas holds nIso values per object
+        void compute( const std::vector<float> &areas, double rho );
+
+        float raw( unsigned i, unsigned k=0 ) const { return _iso[i*_nIso+k]; }
+        double corrected( unsigned i, unsigned k=0 ) const { return _corrected[i*_nIso+k]; }
+
+    private :
+
+        unsigned _nIso;
+        std::vector<float> _iso;
+        std::vector<double> _corrected;
+
+};
+#endif
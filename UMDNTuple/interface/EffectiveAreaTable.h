@@ -0,0 +1,42 @@
+#ifndef EFFECTIVEAREATABLE_H
+#define EFFECTIVEAREATABLE_H
+#include <vector>
+#include <string>
+
+// Effective areas in bins of |eta|, read from one or more of the
+// data/effArea*.txt files.  The files of a table must have the same
+// bins, each bin then holds one area per file.  As with
+// EffectiveAreas, |eta| outside of the bins gives areas of 0.
+// The tables are read once and are not modified afterwards, so they
+// are shared by all streams
+class EffectiveAreaTable {
+
+    public :
+        // paths relative to the CMSSW src area, resolved with edm::FileInPath
+        explicit EffectiveAreaTable( const std::vector<std::string> &files );
+
+        // electron neutral hadron and photon area
+        static const EffectiveAreaTable & electrons();
+        // photon charged hadron, neutral hadron and photon areas
+        static const EffectiveAreaTable & photons();
+
+        unsigned nAreas() const { return _nAreas; }
+
+        // the nAreas() areas of the bin of absEta
+        const float * areas( float absEta ) const;
+
+        // the areas of each absEta, nAreas() values per object
+        void areas( const std::vector<float> &absEta, std::vector<float> &result ) const;
+
+    private :
+
+        int bin( float absEta ) const;
+
+        std::vector<float> _absEtaMin;
+        std::vector<float> _absEtaMax;
+        // nAreas values per bin, followed by the areas outside the bins
+        std::vector<float> _areas;
+        unsigned _nAreas;
+
+};
+#endif
@@ -5,10 +5,15 @@
 #include "TTree.h"
 #include "DataFormats/PatCandidates/interface/Electron.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "UMDNTuple/UMDNTuple/interface/ColumnSet.h"
+#include "UMDNTuple/UMDNTuple/interface/KeyIndexCache.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
+#include "UMDNTuple/UMDNTuple/interface/ConversionIndex.h"
 
 #include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
 #include "DataFormats/BeamSpot/interface/BeamSpot.h"
-#include "RecoEgamma/EgammaTools/interface/EffectiveAreas.h"
+#include "UMDNTuple/UMDNTuple/interface/EffectiveAreaTable.h"
+#include "UMDNTuple/UMDNTuple/interface/EGammaKernels.h"
 
 enum ElectronUserVar {
 
@@ -29,25 +34,25 @@ class ElectronProducer {
         //void initialize( const TTree *tree );
         void initialize( const std::string &prefix, 
                          const edm::EDGetTokenT<edm::View<pat::Electron> >&elecTok, 
-                         TTree *tree, float minPt=5, int detail=99 );
+                         TTree *tree, float minPt=5, int detail=99,
+                         const BranchSelection &selection=BranchSelection() );
 
         //void addUserBool ( ElectronUserVar , const edm::EDGetTokenT<edm::ValueMap<Bool_t> > & );
         void addUserString( ElectronUserVar type, const std::string userString ) ;
 
-        void addConversionsToken( const edm::EDGetTokenT<reco::ConversionCollection> & );
-        void addBeamSpotToken( const edm::EDGetTokenT<reco::BeamSpot> & );
-        void addVertexToken( const edm::EDGetTokenT<std::vector<reco::Vertex> > & );
-        void addRhoToken( const edm::EDGetTokenT<double> & );
         void addEnergyCalib( const std::string eneCalib) ;
+        // writes the electrons by decreasing calibrated pt,
+        // with their collection index in el_origIdx
+        void sortByCalibratedPt();
 
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext &context );
 
 
     private :
 
         std::string _prefix;
 
-        int el_n;
+        ColumnSet _columns;
 
         std::vector<float> *el_pt;
         std::vector<float> *el_eta;
@@ -109,15 +114,27 @@ class ElectronProducer {
 
         std::string _eneCalib;
 
-        EffectiveAreas _effectiveAreas;
+        // the booked VID columns and the index of their id
+        std::vector<std::pair<std::vector<Bool_t>*, unsigned> > _ids;
+        KeyIndexCache _idIndex;
 
-        edm::EDGetTokenT<reco::ConversionCollection> _conversionsToken;
-        edm::EDGetTokenT<reco::BeamSpot> _beamSpotToken;
-        edm::EDGetTokenT<std::vector<reco::Vertex> > _vertexToken;
-        edm::EDGetTokenT<double> _rhoToken;
+        const EffectiveAreaTable & _effectiveAreas;
+        // |eta| of the electrons and their areas
+        std::vector<float> _absEta;
+        std::vector<float> _areas;
+        CalibratedKinematics _kinematics;
+        CorrectedIsolation _isolation;
+
+        bool _sortByPt;
+        std::vector<int> *el_origIdx;
+        std::vector<unsigned> _order;
 
         int _detail;
         float _minPt;
 
+        // the conversion matching is only done if its column is booked
+        bool _doConvVeto;
+        ConversionIndex _conversions;
+
 };
 #endif
@@ -0,0 +1,56 @@
+#ifndef EVENTCONTEXT_H
+#define EVENTCONTEXT_H
+#include <vector>
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
+#include "DataFormats/EgammaCandidates/interface/ConversionFwd.h"
+
+// Products used by several producers, fetched once per event by
+// fill() and passed to the produce() of every producer.  Products
+// whose tag is not configured are not fetched, their handles stay
+// invalid
+class EventContext {
+
+    public :
+        EventContext();
+
+        void initialize( const edm::EDGetTokenT<std::vector<reco::Vertex> > &vertexTok,
+                         const edm::EDGetTokenT<double> &rhoTok,
+                         const edm::EDGetTokenT<reco::BeamSpot> &beamSpotTok,
+                         const edm::EDGetTokenT<reco::ConversionCollection> &conversionsTok );
+
+        void fill( const edm::Event &iEvent );
+
+        const edm::Handle<std::vector<reco::Vertex> > & vertices() const { return _vertices; }
+        const edm::Handle<reco::BeamSpot> & beamSpot() const { return _beamSpot; }
+        const edm::Handle<reco::ConversionCollection> & conversions() const { return _conversions; }
+
+        // the first vertex, 0 without vertices
+        const reco::Vertex * firstVertex() const { return _firstVertex; }
+        // the first vertex if it is not fake, otherwise 0
+        const reco::Vertex * primaryVertex() const { return _primaryVertex; }
+
+        double rho() const { return *_rho; }
+        // rho, at least 0
+        double rhoPrime() const { return _rhoPrime; }
+
+    private :
+
+        edm::EDGetTokenT<std::vector<reco::Vertex> > _vertexToken;
+        edm::EDGetTokenT<double> _rhoToken;
+        edm::EDGetTokenT<reco::BeamSpot> _beamSpotToken;
+        edm::EDGetTokenT<reco::ConversionCollection> _conversionsToken;
+
+        edm::Handle<std::vector<reco::Vertex> > _vertices;
+        edm::Handle<double> _rho;
+        edm::Handle<reco::BeamSpot> _beamSpot;
+        edm::Handle<reco::ConversionCollection> _conversions;
+
+        const reco::Vertex *_firstVertex;
+        const reco::Vertex *_primaryVertex;
+        double _rhoPrime;
+
+};
+#endif
@@ -10,6 +10,7 @@
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
 #include "SimDataFormats/GeneratorProducts/interface/LHERunInfoProduct.h"
 #include "SimDataFormats/GeneratorProducts/interface/LHEEventProduct.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
 
 class EventInfoProducer {
@@ -18,19 +19,17 @@ class EventInfoProducer {
         EventInfoProducer();
 
         void initialize( 
-                        const edm::EDGetTokenT<std::vector<reco::Vertex> > & , 
                         const edm::EDGetTokenT<std::vector<PileupSummaryInfo> > & ,
                         const edm::EDGetTokenT<GenEventInfoProduct> & ,
                         const edm::EDGetTokenT<LHEEventProduct> & , 
                         const edm::EDGetTokenT<LHERunInfoProduct> & , 
                         const edm::EDGetTokenT<double> & ,
                         const edm::EDGetTokenT<double> & ,
-                        const edm::EDGetTokenT<double> & ,
                         const edm::EDGetTokenT<double> & ,
 			 TTree *, TTree *, bool, bool);
 
         void disableEventWeights() {_disableEventWeights=true;}
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext &context );
 
         void endRun( const edm::Run & );
 
@@ -59,11 +58,9 @@ class EventInfoProducer {
         float pdf_scale;
 
         edm::EDGetTokenT<std::vector<PileupSummaryInfo> > _puToken;
-        edm::EDGetTokenT<std::vector<reco::Vertex> > _vertexToken;
         edm::EDGetTokenT<GenEventInfoProduct> _generatorToken;
         edm::EDGetTokenT<LHEEventProduct> _lheEventToken;
         edm::EDGetTokenT<LHERunInfoProduct> _lheRunToken;
-        edm::EDGetTokenT<double> _rhoToken;
         edm::EDGetTokenT< double > _prefweight_token;
         edm::EDGetTokenT< double > _prefweightup_token;
         edm::EDGetTokenT< double > _prefweightdown_token;
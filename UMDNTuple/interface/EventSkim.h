@@ -0,0 +1,47 @@
+#ifndef EVENTSKIM_H
+#define EVENTSKIM_H
+#include <vector>
+#include <string>
+#include "TTree.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+// Event preselection applied after the producers and before the
+// event is written, configured by the skim PSet
+//
+//  minObjects       : VPSet of { counters, min }, the sum of the
+//                     listed counters (el_n, mu_n, ...) must be at
+//                     least min.  All entries must pass
+//  requiredTriggers : trigger ids, at least one must pass
+//  requiredFilters  : MET filter ids, all must pass
+//
+// Without a skim PSet every event passes
+class EventSkim {
+
+    public :
+        EventSkim();
+        explicit EventSkim( const edm::ParameterSet & );
+
+        // find the counters in the stream tree,
+        // must be called after the producers are booked
+        void bind( TTree *tree );
+
+        bool pass( const std::vector<int> &triggers,
+                   const std::vector<int> &filters ) const;
+
+        bool usesTriggers() const { return !_requiredTriggers.empty(); }
+        bool usesFilters() const { return !_requiredFilters.empty(); }
+
+    private :
+
+        struct Multiplicity {
+            std::vector<std::string> names;
+            std::vector<const int*> counters;
+            int min;
+        };
+
+        std::vector<Multiplicity> _multiplicities;
+        std::vector<int> _requiredTriggers;
+        std::vector<int> _requiredFilters;
+
+};
+#endif
@@ -2,10 +2,13 @@
 #define FATJETPRODUCER_H
 #include <vector>
 #include <string>
+#include <utility>
 #include "TTree.h"
 #include "DataFormats/PatCandidates/interface/Jet.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
 #include "UMDNTuple/UMDNTuple/interface/JetProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/ColumnSet.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
 
 class FatJetProducer {
@@ -16,20 +19,23 @@ class FatJetProducer {
         //void initialize( const TTree *tree );
         void initialize( const std::string &prefix, 
                          const edm::EDGetTokenT<edm::View<pat::Jet> >&jetTok, 
-                         TTree *tree, float minPt = 200 );
+                         TTree *tree, float minPt = 200,
+                         const BranchSelection &selection=BranchSelection() );
 
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext & );
 
 
     private :
 
         std::string _prefix;
 
+        ColumnSet _columns;
+
         std::vector<float> *jet_ak08_prunedMass;
         //std::vector<float> *jet_ak08_FilteredMass;
         std::vector<float> *jet_ak08_SoftDropMass;
         std::vector<float> *jet_ak08_Puppi_SoftDropMass;
-        std::vector<float> *jet_ak08_TrimmedMass;
+        //std::vector<float> *jet_ak08_TrimmedMass;
         std::vector<float> *jet_ak08_tau1;
         std::vector<float> *jet_ak08_tau2;
         std::vector<float> *jet_ak08_tau3;
@@ -37,6 +43,10 @@ class FatJetProducer {
         std::vector<float> *jet_ak08_Puppi_tau2;
         std::vector<float> *jet_ak08_Puppi_tau3;
 
+        // the booked columns and their user floats
+        std::vector<std::pair<std::vector<float>*, std::string> > _userFloats;
+        void addUserFloat( std::vector<float> *column, const std::string &userFloat );
+
         edm::EDGetTokenT<edm::View<pat::Jet> > _jetToken;
         edm::Handle<edm::View<pat::Jet> > jets;
         JetProducer _jetProducer;
@@ -0,0 +1,34 @@
+#ifndef FLOATPRECISION_H
+#define FLOATPRECISION_H
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+// Number of mantissa bits kept for float columns, read from the
+// floatPrecision VPSet.  Each entry gives a list of branch name
+// globs and mantissaBits, later entries override earlier ones.
+// Values are rounded to the nearest representable value so the
+// dropped bits compress to nothing
+class FloatPrecision {
+
+    public :
+        FloatPrecision();
+        explicit FloatPrecision( const edm::ParameterSet & );
+
+        // returns -1 when the branch keeps full precision
+        int mantissaBits( const std::string &branch ) const;
+
+        static void truncate( float *values, size_t n, int bits );
+
+    private :
+
+        struct Rule {
+            std::vector<std::string> patterns;
+            int bits;
+        };
+
+        std::vector<Rule> _rules;
+
+};
+#endif
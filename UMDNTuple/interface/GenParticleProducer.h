@@ -5,6 +5,8 @@
 #include "TTree.h"
 #include "DataFormats/HepMCCandidate/interface/GenParticle.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "UMDNTuple/UMDNTuple/interface/ColumnSet.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
 
 class GenParticleProducer {
@@ -15,16 +17,17 @@ class GenParticleProducer {
         //void initialize( const TTree *tree );
         void initialize( const std::string &prefix, 
                          const edm::EDGetTokenT<std::vector<reco::GenParticle> >&genTok, 
-                         TTree *tree, float minPt =1);
+                         TTree *tree, float minPt =1,
+                         const BranchSelection &selection=BranchSelection() );
 
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext & );
 
 
     private :
 
         std::string _prefix;
 
-        int gen_n;
+        ColumnSet _columns;
 
         std::vector<float> *gen_pt;
         std::vector<float> *gen_eta;
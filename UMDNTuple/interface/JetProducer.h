@@ -2,9 +2,13 @@
 #define JETPRODUCER_H
 #include <vector>
 #include <string>
+#include <utility>
 #include "TTree.h"
 #include "DataFormats/PatCandidates/interface/Jet.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "UMDNTuple/UMDNTuple/interface/ColumnSet.h"
+#include "UMDNTuple/UMDNTuple/interface/KeyIndexCache.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
 
 class JetProducer {
@@ -15,16 +19,17 @@ class JetProducer {
         //void initialize( const TTree *tree );
         void initialize( const std::string &prefix, 
                          const edm::EDGetTokenT<edm::View<pat::Jet> >&jetTok, 
-                         TTree *tree, float minPt=20, int detail=99 );
+                         TTree *tree, float minPt=20, int detail=99,
+                         const BranchSelection &selection=BranchSelection() );
 
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext & );
 
 
     private :
 
         std::string _prefix;
 
-        int jet_n;
+        ColumnSet _columns;
 
         std::vector<float> *jet_pt;
         std::vector<float> *jet_eta;
@@ -51,6 +56,11 @@ class JetProducer {
         std::vector<float> *jet_HFHadE;
         std::vector<float> *jet_HFEmE;
 
+        // the booked b-tag columns and the index of their discriminator
+        std::vector<std::pair<std::vector<float>*, unsigned> > _bTags;
+        KeyIndexCache _bTagIndex;
+        void addBTag( std::vector<float> *column, const std::string &discriminator );
+
         edm::EDGetTokenT<edm::View<pat::Jet> > _jetToken;
         edm::Handle<edm::View<pat::Jet> > jets;
         int _detail;
@@ -0,0 +1,85 @@
+#ifndef KEYINDEXCACHE_H
+#define KEYINDEXCACHE_H
+#include <vector>
+#include <string>
+#include <utility>
+
+// Positions of a fixed list of keys in the (name, value) pairs of
+// PAT objects, electronIDs(), photonIDs() or getPairDiscri().  PAT
+// looks up each name with a linear scan of string comparisons, here
+// the keys are resolved once for each list signature, the length
+// and the first name of the list, and the values are then read by
+// index.  A key missing from the list is remembered as missing
+// until the signature changes.  Each read checks that the name at
+// the cached index is still the key, and only that key is resolved
+// again when it is not.
+// reset() must be called before each collection.  Missing keys throw
+// if required, otherwise they give the missing value
+class KeyIndexCache {
+
+    public :
+        explicit KeyIndexCache( bool required=true, float missing=0 );
+
+        // returns the index of the key to pass to value()
+        unsigned add( const std::string &key );
+        void clear();
+
+        void reset() { _size = -1; }
+
+        template<class V>
+        V value( const std::vector<std::pair<std::string, V> > &pairs, unsigned key ) {
+            if( static_cast<int>( pairs.size() ) != _size ||
+                    ( !pairs.empty() && pairs[0].first != _first ) ) {
+                resolve( pairs );
+            }
+            int idx = _index[key];
+            if( idx >= 0 && pairs[idx].first != _keys[key] ) {
+                resolve( pairs, key );
+                idx = _index[key];
+            }
+            if( idx < 0 ) return missing( key );
+            return pairs[idx].second;
+        }
+
+    private :
+
+        template<class V>
+        void resolve( const std::vector<std::pair<std::string, V> > &pairs );
+        template<class V>
+        void resolve( const std::vector<std::pair<std::string, V> > &pairs, unsigned key );
+        float missing( unsigned key ) const;
+
+        std::vector<std::string> _keys;
+        std::vector<int> _index;
+        // signature of the list the keys were resolved on
+        int _size;
+        std::string _first;
+
+        bool _required;
+        float _missing;
+
+};
+
+template<class V>
+void KeyIndexCache::resolve( const std::vector<std::pair<std::string, V> > &pairs ) {
+
+    for( unsigned i = 0; i < _keys.size(); ++i ) {
+        resolve( pairs, i );
+    }
+    _size = pairs.size();
+    if( pairs.empty() ) _first.clear();
+    else _first = pairs[0].first;
+}
+
+template<class V>
+void KeyIndexCache::resolve( const std::vector<std::pair<std::string, V> > &pairs, unsigned key ) {
+
+    _index[key] = -1;
+    for( unsigned j = 0; j < pairs.size(); ++j ) {
+        if( pairs[j].first == _keys[key] ) {
+            _index[key] = j;
+            break;
+        }
+    }
+}
+#endif
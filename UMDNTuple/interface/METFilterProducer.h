@@ -6,6 +6,8 @@
 #include "FWCore/Framework/interface/EDAnalyzer.h"
 #include "DataFormats/Common/interface/TriggerResults.h"
 #include "FWCore/Common/interface/TriggerNames.h"
+#include "DataFormats/Provenance/interface/ParameterSetID.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
 
 class METFilterProducer {
@@ -17,13 +19,16 @@ class METFilterProducer {
         void initialize( const std::string &prefix, 
                          const edm::EDGetTokenT<edm::TriggerResults >&, 
                          const std::vector<std::string> &,
-                         TTree *, TTree* );
+                         TTree *, TTree*, bool bitmask=false );
 
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext & );
         void addBadChargedCandidateFilterToken( const edm::EDGetTokenT<bool> &);
         void addBadPFMuonFilterToken( const edm::EDGetTokenT<bool> &);
         void endRun( );
 
+        // ids of the filters passed by the current event
+        const std::vector<int> & passingFilters() const { return _passing_filter_ids; }
+
 
     private :
 
@@ -34,9 +39,20 @@ class METFilterProducer {
         edm::EDGetTokenT<bool> _BadPFMuonFilterToken;
 
         std::map<std::string, int> _filter_map;
-        std::vector<std::pair<int, int> > _filter_idx_map;
-
+        // (path index, filter id) pairs for each filter menu,
+        // keyed by the parameter set ID of the filter names
+        std::map<edm::ParameterSetID, std::vector<std::pair<int, int> > > _filter_idx_cache;
+        const std::vector<std::pair<int, int> > *_filter_idx_map;
+        edm::ParameterSetID _filter_menu;
+
+        // passing filter ids, always filled.  Only written
+        // when the bitmask is not used
         std::vector<int> *_passing_filters;
+        std::vector<int> _passing_filter_ids;
+
+        // bit i of the mask is set when filter id i passed
+        bool _bitmask;
+        std::vector<ULong64_t> _filterBits;
 
         TTree *_infoTree;
 
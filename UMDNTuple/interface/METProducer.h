@@ -5,6 +5,7 @@
 #include "TTree.h"
 #include "DataFormats/PatCandidates/interface/MET.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
 
 class METProducer {
@@ -17,7 +18,7 @@ class METProducer {
                          const edm::EDGetTokenT<edm::View<pat::MET> >&metTok, 
                          TTree *tree );
 
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext & );
 
 
     private :
@@ -6,6 +6,8 @@
 #include "DataFormats/PatCandidates/interface/Muon.h"
 #include "DataFormats/MuonReco/interface/MuonSelectors.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "UMDNTuple/UMDNTuple/interface/ColumnSet.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
 
 class MuonProducer {
@@ -16,19 +18,18 @@ class MuonProducer {
         //void initialize( const TTree *tree );
         void initialize( const std::string &prefix, 
                          const edm::EDGetTokenT<edm::View<pat::Muon> >&muonTok, 
-                         TTree *tree, float minPt = 5, int detail=99 );
+                         TTree *tree, float minPt = 5, int detail=99,
+                         const BranchSelection &selection=BranchSelection() );
 
-        void addVertexToken( const edm::EDGetTokenT<std::vector<reco::Vertex> > & );
-        void addRhoToken( const edm::EDGetTokenT<double> & );
-
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext &context );
 
 
     private :
 
         std::string _prefix;
 
-        int mu_n;
+        ColumnSet _columns;
+
         std::vector<float> *mu_pt;
         std::vector<float> *mu_eta;
         std::vector<float> *mu_phi;
@@ -64,8 +65,6 @@ class MuonProducer {
 
         edm::EDGetTokenT<edm::View<pat::Muon> > _muonToken;
         edm::Handle<edm::View<pat::Muon> > muons;
-        edm::EDGetTokenT<std::vector<reco::Vertex> > _vertexToken;
-        edm::EDGetTokenT<double> _rhoToken;
          
         int _detail;
         float _minPt;
@@ -0,0 +1,96 @@
+#ifndef NTUPLEWRITER_H
+#define NTUPLEWRITER_H
+#include <vector>
+#include <string>
+#include <set>
+#include <mutex>
+#include "TTree.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "UMDNTuple/UMDNTuple/interface/TreeOutputSettings.h"
+#include "UMDNTuple/UMDNTuple/interface/FloatPrecision.h"
+#include "UMDNTuple/UMDNTuple/interface/OutputTree.h"
+
+// Owns the output trees of UMDNTuple, shared by all streams.
+// All access to the output file is serialized through mutex().
+// This includes TTree::Fill and its basket compression, and the
+// output branches are pointed to the buffers of the filling stream
+// whenever the stream changes.  Events are written in the order the
+// streams finish them, not in the input order.  Only the producers
+// run in parallel, see asyncOutput for parallel compression
+//
+// Without an outputs VPSet there is a single EventTree, selected by
+// the skim PSet of the module.  Otherwise each entry of outputs is
+// written to the EventTree of its own directory
+//
+//  name : name of the directory
+//  skim : selection of the events written, see EventSkim
+//  keep, drop : branch name globs of the branches written
+//
+// The producers run once per event and every output whose skim
+// passes is filled.  Object columns that no output keeps are not
+// booked and not computed, see ProducerSetup::selection.
+// With the rollover PSet { fileName, maxEvents, maxMB } the
+// EventTrees are written to numbered files of limited size,
+// <fileName>_<n>.root or <fileName>_<name>_<n>.root, each of which
+// receives a copy of all metadata trees at the end of the job.
+// With the asyncOutput PSet { fileName, flushEvents } the EventTrees
+// are written to <fileName>.root or <fileName>_<name>.root through a
+// TBufferMerger, each stream compresses its own baskets outside of
+// the lock and a background thread merges them into the file
+class NTupleWriter {
+
+    public :
+        explicit NTupleWriter( const edm::ParameterSet & );
+        ~NTupleWriter();
+
+        // number of outputs and the configuration of each,
+        // the skim PSet of output i is read from outputConfig(i)
+        unsigned nOutputs() const { return _outputs.size(); }
+        const edm::ParameterSet & outputConfig( unsigned i ) const { return _outputConfigs[i]; }
+
+        // create the output EventTrees using the branch
+        // layout of the first stream tree that is booked
+        void book( TTree *streamTree ) const;
+
+        // count the event for every output and fill the
+        // outputs whose skim passed from a stream tree
+        void fill( TTree *streamTree, const std::vector<bool> &passed ) const;
+
+        // write the skim counts, called once at the end of the job
+        void endJob() const;
+
+        // returns true for the first stream that ends a given run,
+        // the caller must hold the lock on mutex()
+        bool claimRun( unsigned run ) const;
+
+        // apply the output settings to the metadata trees once
+        // their branches are booked, the caller must hold the lock
+        void configureInfoTrees() const;
+
+        std::mutex & mutex() const { return _mutex; }
+
+        TTree * weightInfoTree() const { return _weightInfoTree; }
+        TTree * trigInfoTree()   const { return _trigInfoTree; }
+        TTree * filterInfoTree() const { return _filterInfoTree; }
+
+    private :
+
+        mutable std::mutex _mutex;
+
+        TreeOutputSettings _outputSettings;
+        // one precision for all outputs on purpose.  The outputs
+        // round the stream buffers in place, a precision per output
+        // would change the values seen by the other outputs
+        FloatPrecision _floatPrecision;
+
+        TTree *_weightInfoTree;
+        TTree *_trigInfoTree;
+        TTree *_filterInfoTree;
+
+        std::vector<edm::ParameterSet> _outputConfigs;
+        std::vector<OutputTree*> _outputs;
+
+        mutable std::set<unsigned> _claimedRuns;
+
+};
+#endif
@@ -0,0 +1,183 @@
+#ifndef OUTPUTTREE_H
+#define OUTPUTTREE_H
+#include <vector>
+#include <string>
+#include <map>
+#include <atomic>
+#include <memory>
+#include "TTree.h"
+#include "TFile.h"
+#include "TDirectory.h"
+#include "TBranchElement.h"
+#include "ROOT/TBufferMerger.hxx"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "CommonTools/UtilAlgos/interface/TFileDirectory.h"
+#include "UMDNTuple/UMDNTuple/interface/TreeOutputSettings.h"
+#include "UMDNTuple/UMDNTuple/interface/FloatPrecision.h"
+#include "UMDNTuple/UMDNTuple/interface/BranchSelection.h"
+
+// One output EventTree of the NTupleWriter.  Every stream fills its
+// own memory resident copy of the EventTree, the output tree copies
+// the branch addresses of that tree and fills itself.  The caller
+// serializes all access through the writer mutex
+//
+// keep and drop are lists of branch name globs, a branch is written
+// if it matches any keep pattern (all branches by default) and no
+// drop pattern.
+// With arrayBranches = True the std::vector branches that have a
+// matching counter (el_pt and el_n) are written as variable length
+// arrays, el_pt[el_n]/F, instead of STL collections.
+// Float columns listed in floatPrecision are rounded to fewer
+// mantissa bits just before each fill.
+// With packIdBits = True the std::vector<bool> flags of each object
+// (el_passVIDLoose, mu_isTight, ...) are packed into a single
+// <prefix>_idWord per object, the bit of each flag is written to
+// the IdBitInfoTree.
+// With setRollover the EventTree is written to its own numbered
+// files, <fileName>_0.root, <fileName>_1.root, ... and a new file is
+// started after maxEvents events or once maxBytes are written.  At
+// the end of the job the metadata trees are copied into every file.
+// With setAsync every stream fills its own copy of the EventTree in
+// a TBufferMerger memory file, compressing its baskets on its own
+// thread without taking the writer lock.  Every flushEvents events
+// the buffer is handed to the merger thread that writes the file
+class OutputTree {
+
+    public :
+        OutputTree( const edm::ParameterSet & iConfig, TFileDirectory directory,
+                    bool arrayBranches, bool packIdBits,
+                    const TreeOutputSettings *outputSettings,
+                    const FloatPrecision *floatPrecision );
+        ~OutputTree();
+
+        // write the EventTree to numbered files instead of the
+        // TFileService file, must be called before book.  A limit
+        // of 0 is not applied
+        void setRollover( const std::string &fileName, Long64_t maxEvents, Long64_t maxBytes );
+
+        // write the EventTree to fileName through a TBufferMerger,
+        // must be called before book.  After this fill does not
+        // need the writer lock
+        void setAsync( const std::string &fileName, int flushEvents );
+        bool async() const { return _merger != 0; }
+
+        // create the EventTree using the branch layout of a stream
+        // tree.  In async mode each stream gets its own EventTree
+        void book( TTree *streamTree );
+
+        // fill the EventTree from a stream tree
+        void fill( TTree *streamTree );
+
+        // count an event seen by the skim of this output
+        void count( bool passed ) { ++_nEvents; if( passed ) ++_nPassed; }
+
+        // write the skim counts and close the output files,
+        // the metadata trees are copied into each of them
+        void endJob( const std::vector<TTree*> &metadata );
+
+    private :
+
+        enum ArrayType { kFloat, kDouble, kInt, kUInt, kULong64, kBool };
+
+        // output buffer of a vector branch written as an array
+        struct ArrayColumn {
+            std::string name;
+            std::string counter;
+            ArrayType type;
+            TBranch *target;
+            std::vector<float> floats;
+            std::vector<double> doubles;
+            std::vector<int> ints;
+            std::vector<unsigned> uints;
+            std::vector<ULong64_t> ulongs;
+            std::vector<unsigned char> bools;
+        };
+
+        // the packed flags of one object collection
+        struct IdWord {
+            std::string name;
+            std::string counter;
+            std::vector<std::string> flags;
+            TBranch *target;
+            std::vector<unsigned> words;
+            std::vector<unsigned> *wordsPtr;
+        };
+
+        struct BranchBinding {
+            TBranch *source;
+            TBranch *target;
+            char    *address;
+            // only set for array branches
+            ArrayColumn *array;
+            TBranch *counter;
+            // -1 for full precision
+            int mantissaBits;
+            bool floatVector;
+        };
+
+        struct StreamBinding {
+            std::vector<BranchBinding> branches;
+            // counter and flag branches of each id word
+            std::vector<TBranch*> idCounters;
+            std::vector<std::vector<TBranchElement*> > idFlags;
+        };
+
+        static std::string findCounter( TTree *tree, const std::string &name );
+
+        void checkCounter( TTree *streamTree, const std::string &name,
+                           const std::string &counter ) const;
+
+        void bookIdWords( TTree *streamTree );
+        void bookArrays( TTree *streamTree );
+        void copyArray( const BranchBinding & );
+        void packIdWords( const StreamBinding & );
+
+        StreamBinding & bindings( TTree *streamTree );
+
+        TFile * openFile( unsigned index ) const;
+        void nextFile();
+        // estimated size of the EventTree in the current file
+        Long64_t fileBytes() const;
+        void addMetadata( const std::vector<TTree*> &metadata );
+
+        // the EventTree of one stream in async mode, configured
+        // as parent and writing to directory
+        OutputTree( const OutputTree &parent, TDirectory *directory );
+
+        BranchSelection _selection;
+
+        bool _arrayBranches;
+        bool _packIdBits;
+
+        const TreeOutputSettings *_outputSettings;
+        const FloatPrecision *_floatPrecision;
+
+        TDirectory *_directory;
+
+        TTree *_eventTree;
+        const TTree *_lastStreamTree;
+        TTree *_idBitInfoTree;
+        TTree *_skimInfoTree;
+
+        // only used with rollover
+        std::string _fileName;
+        Long64_t _maxEvents;
+        Long64_t _maxBytes;
+        TFile *_file;
+        std::vector<std::string> _fileNames;
+
+        // only used in async mode
+        ROOT::Experimental::TBufferMerger *_merger;
+        int _flushEvents;
+        std::shared_ptr<ROOT::Experimental::TBufferMergerFile> _mergerFile;
+        std::map<const TTree*, OutputTree*> _streams;
+
+        std::atomic<unsigned long long> _nEvents;
+        std::atomic<unsigned long long> _nPassed;
+
+        std::map<const TTree*, StreamBinding> _bindings;
+        std::vector<ArrayColumn*> _arrays;
+        std::vector<IdWord*> _idWords;
+
+};
+#endif
@@ -8,7 +8,11 @@
 #include "DataFormats/PatCandidates/interface/Electron.h"
 #include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
-#include "RecoEgamma/EgammaTools/interface/EffectiveAreas.h"
+#include "UMDNTuple/UMDNTuple/interface/ColumnSet.h"
+#include "UMDNTuple/UMDNTuple/interface/KeyIndexCache.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
+#include "UMDNTuple/UMDNTuple/interface/EffectiveAreaTable.h"
+#include "UMDNTuple/UMDNTuple/interface/EGammaKernels.h"
 
 enum PhotonUserVar {
 
@@ -36,22 +40,24 @@ class PhotonProducer {
         //void initialize( const TTree *tree );
         void initialize( const std::string &prefix, 
                          const edm::EDGetTokenT<edm::View<pat::Photon> >&photTok, 
-                         TTree *tree, float minPt=5, int detail=99 );
+                         TTree *tree, float minPt=5, int detail=99,
+                         const BranchSelection &selection=BranchSelection() );
         void addUserString ( PhotonUserVar , const std::string userString);
         
         //void addElectronsToken( const edm::EDGetTokenT<edm::View<pat::Electron> > &);
-        void addConversionsToken( const edm::EDGetTokenT<reco::ConversionCollection> &);
-        void addBeamSpotToken( const edm::EDGetTokenT<reco::BeamSpot> &);
         //void addCalibratedToken( const edm::EDGetTokenT<edm::View<pat::Photon> > &);
-        void addRhoToken( const edm::EDGetTokenT<double> & );
         void addEnergyCalib( const std::string eneCalib);
+        // writes the photons by decreasing calibrated pt,
+        // with their collection index in ph_origIdx
+        void sortByCalibratedPt();
         
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext &context );
 
 
         std::string _prefix;
 
-        int ph_n;
+        ColumnSet _columns;
+
         std::vector<float> *ph_pt;
         std::vector<float> *ph_eta;
         std::vector<float> *ph_phi;
@@ -109,20 +115,28 @@ class PhotonProducer {
         std::string  _VIDMedium;
         std::string  _VIDTight;
 
+        // the booked VID columns and the index of their id
+        std::vector<std::pair<std::vector<Bool_t>*, unsigned> > _ids;
+        KeyIndexCache _idIndex;
+
         std::string _ChIso;
         std::string _NeuIso;
         std::string _PhoIso;
 
         std::string _eneCalib;
 
-        EffectiveAreas _effectiveAreasCH;
-        EffectiveAreas _effectiveAreasNH;
-        EffectiveAreas _effectiveAreasPH;
+        const EffectiveAreaTable & _effectiveAreas;
+        // |eta| of the photons and their areas
+        std::vector<float> _absEta;
+        std::vector<float> _areas;
+        CalibratedKinematics _kinematics;
+        CorrectedIsolation _isolation;
+
+        bool _sortByPt;
+        std::vector<int> *ph_origIdx;
+        std::vector<unsigned> _order;
 
         edm::EDGetTokenT<edm::View<pat::Electron> > _ElectronsToken;
-        edm::EDGetTokenT<reco::ConversionCollection> _ConversionsToken;
-        edm::EDGetTokenT<reco::BeamSpot> _beamSpotToken;
-        edm::EDGetTokenT<double> _rhoToken;
 
         //edm::EDGetTokenT<edm::ValueMap<float> > 
         int _detail;
@@ -0,0 +1,62 @@
+#ifndef PRODUCERSETUP_H
+#define PRODUCERSETUP_H
+#include <string>
+#include "TTree.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+
+#include "UMDNTuple/UMDNTuple/interface/EventInfoProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/ElectronProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/GenParticleProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/MuonProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/PhotonProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/JetProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/FatJetProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/METProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/METFilterProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/TriggerProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/BranchSelection.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
+
+// Configures the object producers from the UMDNTuple parameter set.
+// Shared by the UMDNTuple module and the standalone table producers
+// so that both read the same parameter names
+class ProducerSetup {
+
+    public :
+
+        static void setup( EventContext &, const edm::ParameterSet &,
+                           edm::ConsumesCollector & );
+        static void setup( EventInfoProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree );
+        static void setup( ElectronProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree=0 );
+        static void setup( MuonProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree=0 );
+        static void setup( PhotonProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree=0 );
+        static void setup( JetProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree=0 );
+        static void setup( FatJetProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree=0 );
+        static void setup( METProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree=0 );
+        static void setup( METFilterProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree );
+        static void setup( TriggerProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree );
+        static void setup( GenParticleProducer &, const edm::ParameterSet &,
+                           edm::ConsumesCollector &, TTree *tree, TTree *infoTree=0 );
+
+    private :
+
+        static std::string prefix( const edm::ParameterSet &, const std::string &name,
+                                   const std::string &def );
+        static float minPt( const edm::ParameterSet &, const std::string &name );
+        static int detail( const edm::ParameterSet &, const std::string &name );
+        static bool sortByPt( const edm::ParameterSet &, const std::string &name );
+        static BranchSelection selection( const edm::ParameterSet & );
+        static bool bitmask( const edm::ParameterSet & );
+
+};
+#endif
@@ -0,0 +1,46 @@
+#ifndef TREEOUTPUTSETTINGS_H
+#define TREEOUTPUTSETTINGS_H
+#include <vector>
+#include <string>
+#include <map>
+#include "TTree.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+// Compression, basket size and AutoFlush settings of the output
+// trees, read from the treeSettings VPSet.  Each entry names a tree
+// and can hold branchGroups, lists of branch name globs with their
+// own compression and basket size.  Groups are applied in order so
+// a later group overrides an earlier one.  Anything not configured
+// keeps the ROOT default
+class TreeOutputSettings {
+
+    public :
+        TreeOutputSettings();
+        explicit TreeOutputSettings( const edm::ParameterSet & );
+
+        // apply the settings for this tree to all of its branches
+        void apply( TTree *tree ) const;
+
+    private :
+
+        struct BranchGroup {
+            std::vector<std::string> patterns;
+            int compression;
+            int basketSize;
+        };
+
+        struct TreeSettings {
+            int compression;
+            int basketSize;
+            Long64_t autoFlush;
+            bool setAutoFlush;
+            std::vector<BranchGroup> groups;
+        };
+
+        static int compression( const edm::ParameterSet & );
+        static int basketSize( const edm::ParameterSet & );
+
+        std::map<std::string, TreeSettings> _trees;
+
+};
+#endif
@@ -9,7 +9,17 @@
 #include "DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h"
 //#include "PhysicsTools/PatUtils/interface/TriggerHelper.h"
 #include "FWCore/Common/interface/TriggerNames.h"
+#include "DataFormats/Provenance/interface/ParameterSetID.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 
+// storage of the triggers passed by each HLT object
+enum HLTObjLayout {
+
+    HLTObjNested = 0,   // HLTObj_passTriggers, one vector of ids per object
+    HLTObjCSR = 1,      // flat HLTObjTrig_id with a start offset per object
+    HLTObjBitmask = 2   // HLTObj_trigBits<i>, bit id%64 of word id/64
+
+};
 
 class TriggerProducer {
 
@@ -21,11 +31,15 @@ class TriggerProducer {
                          const edm::EDGetTokenT<edm::TriggerResults >&, 
                          const edm::EDGetTokenT<pat::TriggerObjectStandAloneCollection>&, 
                          const std::vector<std::string> &,
-                         TTree *, TTree* );
+                         TTree *, TTree*, bool bitmask=false,
+                         HLTObjLayout layout=HLTObjNested );
 
-        void produce(const edm::Event &iEvent );
+        void produce(const edm::Event &iEvent, const EventContext & );
         void endRun( );
 
+        // ids of the triggers passed by the current event
+        const std::vector<int> & passingTriggers() const { return _passing_trigger_ids; }
+
 
     private :
 
@@ -36,9 +50,27 @@ class TriggerProducer {
 
         //std::vector<int> _trigger_indices;
         std::map<std::string, int> _trigger_map;
-        std::vector<std::pair<int, int> > _trigger_idx_map;
-
+        // (path index, trigger id) pairs for each trigger menu,
+        // keyed by the parameter set ID of the trigger names
+        std::map<edm::ParameterSetID, std::vector<std::pair<int, int> > > _trigger_idx_cache;
+        const std::vector<std::pair<int, int> > *_trigger_idx_map;
+        // trigger id of each "HLT" path index, -1 for other
+        // paths, per menu
+        std::map<edm::ParameterSetID, std::vector<int> > _trigger_path_cache;
+        const std::vector<int> *_trigger_path_ids;
+        edm::ParameterSetID _trigger_menu;
+
+        // copy of the current trigger object, unpacking
+        // its path names needs a non-const object
+        pat::TriggerObjectStandAlone _trigObj;
+        std::vector<int> _passed_trigs;
+
+        void addPath( unsigned pathIndex );
+
+        // passing trigger ids, always filled.  Only written
+        // when the bitmask is not used
         std::vector<int> *_passing_triggers;
+        std::vector<int> _passing_trigger_ids;
 
         int HLTObj_n;
         std::vector<float> *HLTObj_pt;
@@ -47,15 +79,23 @@ class TriggerProducer {
         std::vector<float> *HLTObj_e;
         std::vector<std::vector< int > > *HLTObj_passTriggers;
 
-        //ULong64_t triggerBits;
+        HLTObjLayout _hltObjLayout;
+        // compressed sparse row layout
+        std::vector< int > *HLTObj_trigOffset;
+        int HLTObjTrig_n;
+        std::vector< int > *HLTObjTrig_id;
+        // bitmask layout, one branch per 64 trigger ids
+        std::vector<std::vector< ULong64_t > *> HLTObj_trigBits;
+
+        // bit i of the mask is set when trigger id i passed
+        bool _bitmask;
+        std::vector<ULong64_t> _triggerBits;
 
         edm::EDGetTokenT<edm::TriggerResults> _trigToken;
         edm::EDGetTokenT<pat::TriggerObjectStandAloneCollection> _trigObjToken;
 
         TTree *_infoTree;
 
-        int _prevRunNumber;
-
 
 };
 #endif
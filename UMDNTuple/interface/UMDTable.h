@@ -0,0 +1,64 @@
+#ifndef UMDTABLE_H
+#define UMDTABLE_H
+#include <vector>
+#include <string>
+
+// One named column of a UMDTable.  Only the storage
+// matching the column type is filled.  Scalar columns
+// hold exactly length entries per event, length is
+// only above one for fixed size arrays
+class UMDTableColumn {
+
+    public :
+
+        enum ColumnType {
+            kFloat = 0,
+            kDouble = 1,
+            kInt = 2,
+            kUInt = 3,
+            kBool = 4,
+            kIntVector = 5,
+            kULong64 = 6
+        };
+
+        UMDTableColumn() : type(kFloat), scalar(false), length(1) {}
+        UMDTableColumn( const std::string &n, ColumnType t, bool s, unsigned l=1 ) :
+            name(n), type(t), scalar(s), length(l) {}
+
+        std::string name;
+        int type;
+        bool scalar;
+        unsigned length;
+
+        std::vector<float> floats;
+        std::vector<double> doubles;
+        std::vector<int> ints;
+        std::vector<unsigned> uints;
+        std::vector<bool> bools;
+        std::vector<std::vector<int> > intVectors;
+        std::vector<unsigned long long> ulongs;
+
+};
+
+// Columnar event product written by the standalone
+// table producers and serialized by UMDTableNTuple
+class UMDTable {
+
+    public :
+        UMDTable() {}
+
+        UMDTableColumn & addColumn( const std::string &name,
+                                    UMDTableColumn::ColumnType type, bool scalar,
+                                    unsigned length=1 ) {
+            _columns.push_back( UMDTableColumn( name, type, scalar, length ) );
+            return _columns.back();
+        }
+
+        const std::vector<UMDTableColumn> & columns() const { return _columns; }
+
+    private :
+
+        std::vector<UMDTableColumn> _columns;
+
+};
+#endif
@@ -0,0 +1,57 @@
+#ifndef TABLEPRODUCER_H
+#define TABLEPRODUCER_H
+#include <vector>
+#include <string>
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "UMDNTuple/UMDNTuple/interface/UMDTable.h"
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
+
+// Runs one of the object producers as a standalone module and puts
+// its branches into the event as a UMDTable.  The producer fills a
+// memory resident tree, exactly as it does inside UMDNTuple, and the
+// branches of that tree are copied into the table columns.
+// Branches of a type that has no column type throw
+// a Configuration exception.
+// The module reads the same parameters as UMDNTuple.
+// It is a stream module and not a global one: every producer keeps
+// its event in its own tree and branch vectors, so each stream needs
+// its own producer.  ProducerSetup registers the producer tokens
+// with consumes while it configures the producer, and consumes is
+// only allowed in the constructor.  A global module would have to
+// create these producers in beginStream, which is too late
+template<class P>
+class TableProducer : public edm::stream::EDProducer<> {
+
+    public :
+        explicit TableProducer( const edm::ParameterSet & );
+        ~TableProducer();
+
+    private :
+
+        virtual void produce( edm::Event &, const edm::EventSetup & ) override;
+
+        struct ColumnReader {
+            TBranch *branch;
+            TLeaf *leaf;
+            UMDTableColumn::ColumnType type;
+            bool scalar;
+            // entries of a leaf, more than one for fixed size arrays
+            unsigned length;
+        };
+
+        void bookColumns();
+
+        EventContext _context;
+        P _producer;
+
+        TTree *_tree;
+        TTree *_infoTree;
+
+        std::vector<ColumnReader> _readers;
+
+};
+#endif
@@ -0,0 +1,176 @@
+#include <typeinfo>
+#include "UMDNTuple/UMDNTuple/plugins/TableProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/ProducerSetup.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "TBranchElement.h"
+#include "TClass.h"
+#include "TObjArray.h"
+
+template<class T, class S>
+static void assign( std::vector<T> &column, const S *values, unsigned n ) {
+
+    column.assign( values, values + n );
+}
+
+template<class P>
+TableProducer<P>::TableProducer( const edm::ParameterSet & iConfig ) :
+    _tree(0),
+    _infoTree(0)
+{
+    // the trees are only used to collect the producer branches
+    _tree = new TTree( "EventTree", "EventTree" );
+    _tree->SetDirectory( 0 );
+    _infoTree = new TTree( "InfoTree", "InfoTree" );
+    _infoTree->SetDirectory( 0 );
+
+    edm::ConsumesCollector iC = consumesCollector();
+    ProducerSetup::setup( _context, iConfig, iC );
+    ProducerSetup::setup( _producer, iConfig, iC, _tree, _infoTree );
+
+    bookColumns();
+
+    produces<UMDTable>();
+}
+
+template<class P>
+TableProducer<P>::~TableProducer() {
+
+    delete _tree;
+    delete _infoTree;
+
+}
+
+template<class P>
+void TableProducer<P>::bookColumns() {
+
+    TClass *floatClass  = TClass::GetClass( typeid( std::vector<float> ) );
+    TClass *doubleClass = TClass::GetClass( typeid( std::vector<double> ) );
+    TClass *intClass    = TClass::GetClass( typeid( std::vector<int> ) );
+    TClass *uintClass   = TClass::GetClass( typeid( std::vector<unsigned> ) );
+    TClass *boolClass   = TClass::GetClass( typeid( std::vector<bool> ) );
+    TClass *intVecClass = TClass::GetClass( typeid( std::vector<std::vector<int> > ) );
+    TClass *ulongClass  = TClass::GetClass( typeid( std::vector<ULong64_t> ) );
+
+    TObjArray *branches = _tree->GetListOfBranches();
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+
+        ColumnReader reader;
+        reader.branch = static_cast<TBranch*>( branches->UncheckedAt(i) );
+        reader.leaf = 0;
+        reader.length = 1;
+
+        TBranchElement *element = dynamic_cast<TBranchElement*>( reader.branch );
+        if( element ) {
+            // std::vector branches
+            TClass *cl = TClass::GetClass( element->GetClassName() );
+            reader.scalar = false;
+            if(      cl == floatClass  ) reader.type = UMDTableColumn::kFloat;
+            else if( cl == doubleClass ) reader.type = UMDTableColumn::kDouble;
+            else if( cl == intClass    ) reader.type = UMDTableColumn::kInt;
+            else if( cl == uintClass   ) reader.type = UMDTableColumn::kUInt;
+            else if( cl == boolClass   ) reader.type = UMDTableColumn::kBool;
+            else if( cl == intVecClass ) reader.type = UMDTableColumn::kIntVector;
+            else if( cl == ulongClass  ) reader.type = UMDTableColumn::kULong64;
+            else {
+                throw cms::Exception("Configuration")
+                << "Branch " << reader.branch->GetName() << " of type "
+                << element->GetClassName() << " has no table column type";
+            }
+        }
+        else {
+            // single value or fixed size array leaf list branches
+            reader.leaf = static_cast<TLeaf*>( reader.branch->GetListOfLeaves()->At(0) );
+            reader.scalar = true;
+            std::string type = reader.leaf->GetTypeName();
+            if(      type == "Float_t"   ) reader.type = UMDTableColumn::kFloat;
+            else if( type == "Double_t"  ) reader.type = UMDTableColumn::kDouble;
+            else if( type == "Int_t"     ) reader.type = UMDTableColumn::kInt;
+            else if( type == "UInt_t"    ) reader.type = UMDTableColumn::kUInt;
+            else if( type == "Bool_t"    ) reader.type = UMDTableColumn::kBool;
+            else if( type == "ULong64_t" ) reader.type = UMDTableColumn::kULong64;
+            else {
+                throw cms::Exception("Configuration")
+                << "Branch " << reader.branch->GetName() << " of type "
+                << type << " has no table column type";
+            }
+            if( reader.branch->GetListOfLeaves()->GetEntriesFast() != 1 || reader.leaf->GetLeafCount() ) {
+                throw cms::Exception("Configuration")
+                << "Branch " << reader.branch->GetName()
+                << " is not a single leaf of fixed size";
+            }
+            reader.length = reader.leaf->GetLen();
+        }
+
+        _readers.push_back( reader );
+    }
+}
+
+template<class P>
+void TableProducer<P>::produce( edm::Event & iEvent, const edm::EventSetup & ) {
+
+    _context.fill( iEvent );
+    _producer.produce( iEvent, _context );
+
+    std::unique_ptr<UMDTable> table( new UMDTable() );
+
+    for( typename std::vector<ColumnReader>::const_iterator itr = _readers.begin();
+            itr != _readers.end(); ++itr ) {
+
+        UMDTableColumn & column = table->addColumn( itr->branch->GetName(), itr->type,
+                                                    itr->scalar, itr->length );
+
+        if( itr->scalar ) {
+            // the leaf buffer holds length values of the leaf type
+            void *values = itr->leaf->GetValuePointer();
+            switch( itr->type ) {
+                case UMDTableColumn::kFloat  : assign( column.floats , static_cast<Float_t*>( values ), itr->length ); break;
+                case UMDTableColumn::kDouble : assign( column.doubles, static_cast<Double_t*>( values ), itr->length ); break;
+                case UMDTableColumn::kInt    : assign( column.ints   , static_cast<Int_t*>( values ), itr->length ); break;
+                case UMDTableColumn::kUInt   : assign( column.uints  , static_cast<UInt_t*>( values ), itr->length ); break;
+                case UMDTableColumn::kBool   : assign( column.bools  , static_cast<Bool_t*>( values ), itr->length ); break;
+                case UMDTableColumn::kULong64: assign( column.ulongs , static_cast<ULong64_t*>( values ), itr->length ); break;
+                default : break;
+            }
+            continue;
+        }
+
+        void *object = static_cast<TBranchElement*>( itr->branch )->GetObject();
+        if( !object ) continue;
+
+        switch( itr->type ) {
+            case UMDTableColumn::kFloat     : column.floats     = *static_cast<std::vector<float>*>( object ); break;
+            case UMDTableColumn::kDouble    : column.doubles    = *static_cast<std::vector<double>*>( object ); break;
+            case UMDTableColumn::kInt       : column.ints       = *static_cast<std::vector<int>*>( object ); break;
+            case UMDTableColumn::kUInt      : column.uints      = *static_cast<std::vector<unsigned>*>( object ); break;
+            case UMDTableColumn::kBool      : column.bools      = *static_cast<std::vector<bool>*>( object ); break;
+            case UMDTableColumn::kIntVector : column.intVectors = *static_cast<std::vector<std::vector<int> >*>( object ); break;
+            case UMDTableColumn::kULong64   : column.ulongs     = *static_cast<std::vector<ULong64_t>*>( object ); break;
+        }
+    }
+
+    iEvent.put( std::move( table ) );
+}
+
+typedef TableProducer<EventInfoProducer>   EventInfoTableProducer;
+typedef TableProducer<ElectronProducer>    ElectronTableProducer;
+typedef TableProducer<MuonProducer>        MuonTableProducer;
+typedef TableProducer<PhotonProducer>      PhotonTableProducer;
+typedef TableProducer<JetProducer>         JetTableProducer;
+typedef TableProducer<FatJetProducer>      FatJetTableProducer;
+typedef TableProducer<METProducer>         METTableProducer;
+typedef TableProducer<METFilterProducer>   METFilterTableProducer;
+typedef TableProducer<TriggerProducer>     TriggerTableProducer;
+typedef TableProducer<GenParticleProducer> GenParticleTableProducer;
+
+DEFINE_FWK_MODULE(EventInfoTableProducer);
+DEFINE_FWK_MODULE(ElectronTableProducer);
+DEFINE_FWK_MODULE(MuonTableProducer);
+DEFINE_FWK_MODULE(PhotonTableProducer);
+DEFINE_FWK_MODULE(JetTableProducer);
+DEFINE_FWK_MODULE(FatJetTableProducer);
+DEFINE_FWK_MODULE(METTableProducer);
+DEFINE_FWK_MODULE(METFilterTableProducer);
+DEFINE_FWK_MODULE(TriggerTableProducer);
+DEFINE_FWK_MODULE(GenParticleTableProducer);
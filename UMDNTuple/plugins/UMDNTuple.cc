@@ -0,0 +1,174 @@
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "UMDNTuple/UMDNTuple/plugins/UMDNTuple.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/stream/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "UMDNTuple/UMDNTuple/interface/ProducerSetup.h"
+
+UMDNTuple::UMDNTuple( const edm::ParameterSet & iConfig, const NTupleWriter *writer ) :
+    _myTree(0),
+    _weightInfoTree(0),
+    _trigInfoTree(0),
+    _filterInfoTree(0),
+    _produceEvent(true),
+    _produceElecs(true),
+    _produceMuons(true),
+    _producePhots(true),
+    _produceJets(true),
+    _produceFJets(true),
+    _produceMET(true),
+    _produceMETFilter(true),
+    _produceTrig(true),
+    _produceGen(true),
+    _isMC( -1 )
+{
+
+    // Get config flags
+    if( !iConfig.exists( "isMC" ) ) {
+        throw cms::Exception("CorruptData")
+        << "Must provide isMC flag so we can handle the data/MC properly";
+    }
+
+    _isMC = iConfig.getUntrackedParameter<int>("isMC");
+    _doPref = iConfig.getUntrackedParameter<bool>("doPref");
+
+    // Create tree to store event data for this stream.
+    // It is never written, the writer copies its branch
+    // addresses to the output EventTree
+    _myTree = new TTree( "EventTree", "EventTree" );
+    _myTree->SetDirectory( 0 );
+    // metadata trees are shared by all streams
+    _weightInfoTree = writer->weightInfoTree();
+    _trigInfoTree = writer->trigInfoTree();
+    _filterInfoTree = writer->filterInfoTree();
+
+    // flags to enable or disable production
+    // of objects based on the provided tags
+   // _produceJets      = iConfig.exists( "jetTag" );
+   // _produceFJets     = iConfig.exists( "fatjetTag" );
+   // _produceElecs     = iConfig.exists( "electronTag" );
+   // _produceMuons     = iConfig.exists( "muonTag" );
+   // _producePhots     = iConfig.exists( "photonTag" );
+   // _produceMET       = iConfig.exists( "metTag" );
+   // _produceMETFilter = iConfig.exists( "metFilterTag" );
+   // _produceTrig      = iConfig.exists( "triggerTag" );
+   // _produceGen       = iConfig.exists( "genParticleTag" );
+
+    if( !_isMC ) _produceGen = false;
+
+    // the object configuration is shared with 
+    // the standalone table producers
+    edm::ConsumesCollector iC = consumesCollector();
+
+    // products shared by several producers
+    ProducerSetup::setup( _context, iConfig, iC );
+
+    // Event information
+    ProducerSetup::setup( _eventProducer, iConfig, iC, _myTree, _weightInfoTree );
+
+    if( _produceElecs )     ProducerSetup::setup( _elecProducer     , iConfig, iC, _myTree );
+    if( _produceMuons )     ProducerSetup::setup( _muonProducer     , iConfig, iC, _myTree );
+    if( _producePhots )     ProducerSetup::setup( _photProducer     , iConfig, iC, _myTree );
+    if( _produceJets  )     ProducerSetup::setup( _jetProducer      , iConfig, iC, _myTree );
+    if( _produceFJets )     ProducerSetup::setup( _fjetProducer     , iConfig, iC, _myTree );
+    if( _produceMET   )     ProducerSetup::setup( _metProducer      , iConfig, iC, _myTree );
+    if( _produceMETFilter ) ProducerSetup::setup( _metFilterProducer, iConfig, iC, _myTree, _filterInfoTree );
+    if( _produceTrig  )     ProducerSetup::setup( _trigProducer     , iConfig, iC, _myTree, _trigInfoTree );
+    if( _produceGen   )     ProducerSetup::setup( _genProducer      , iConfig, iC, _myTree );
+
+    for( unsigned i = 0; i < writer->nOutputs(); ++i ) {
+        EventSkim skim( writer->outputConfig( i ) );
+        skim.bind( _myTree );
+        if( ( skim.usesTriggers() && !_produceTrig ) ||
+            ( skim.usesFilters() && !_produceMETFilter ) ) {
+            throw cms::Exception("Configuration")
+            << "The skim requires triggers or MET filters that are not produced";
+        }
+        _skims.push_back( skim );
+    }
+    _passed.resize( _skims.size() );
+
+    writer->book( _myTree );
+
+}
+
+std::unique_ptr<NTupleWriter> UMDNTuple::initializeGlobalCache( const edm::ParameterSet & iConfig ) {
+
+    // printed once here and not by every stream.  All
+    // producers are enabled, except gen particles for data
+    bool produceGen = true;
+    if( iConfig.exists( "isMC" ) ) produceGen = iConfig.getUntrackedParameter<int>("isMC");
+
+    edm::LogInfo("UMDNTuple")
+        << " _produceJets 1\n"
+        << " _produceFJets 1\n"
+        << " _produceElecs 1\n"
+        << " _produceMuons 1\n"
+        << " _producePhots 1\n"
+        << " _produceMET 1\n"
+        << " _produceMETFilter 1\n"
+        << " _produceTrig 1\n"
+        << " _produceGen " << produceGen;
+
+    return std::unique_ptr<NTupleWriter>( new NTupleWriter( iConfig ) );
+
+}
+
+void UMDNTuple::globalEndJob( NTupleWriter *writer ) {
+
+    writer->endJob();
+
+}
+
+void UMDNTuple::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup) {
+    _context.fill( iEvent );
+
+    _eventProducer.produce( iEvent, _context );
+    if( _produceElecs )         _elecProducer      .produce( iEvent, _context );
+    if( _produceMuons )         _muonProducer      .produce( iEvent, _context );
+    if( _producePhots )         _photProducer      .produce( iEvent, _context );
+    if( _produceJets  )         _jetProducer       .produce( iEvent, _context );
+    if( _produceFJets )         _fjetProducer      .produce( iEvent, _context );
+    if( _produceMET   )         _metProducer       .produce( iEvent, _context );
+    if( _produceMETFilter  )    _metFilterProducer .produce( iEvent, _context );
+    if( _produceTrig  )         _trigProducer      .produce( iEvent, _context );
+    if( _produceGen && _isMC  ) _genProducer       .produce( iEvent, _context );
+
+    // events rejected by the skim of an output are
+    // counted but not written to it
+    for( unsigned i = 0; i < _skims.size(); ++i ) {
+        _passed[i] = _skims[i].pass( _trigProducer.passingTriggers(),
+                                     _metFilterProducer.passingFilters() );
+    }
+    globalCache()->fill( _myTree, _passed );
+}
+
+void UMDNTuple::endRun( edm::Run const& iRun, edm::EventSetup const&) {
+
+  // every stream sees the end of each run, 
+  // only the first one writes the run metadata
+  std::lock_guard<std::mutex> lock( globalCache()->mutex() );
+  if( !globalCache()->claimRun( iRun.run() ) ) return;
+
+  _eventProducer.endRun( iRun );
+  if( _produceMETFilter ) _metFilterProducer.endRun();
+  if( _produceTrig ) _trigProducer.endRun();
+
+  globalCache()->configureInfoTrees();
+
+
+}
+
+UMDNTuple::~UMDNTuple() {
+
+    delete _myTree;
+
+};
+
+
+DEFINE_FWK_MODULE(UMDNTuple);
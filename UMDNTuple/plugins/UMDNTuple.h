@@ -2,8 +2,9 @@
 #define UMDNTUPLE_H
 #include <vector>
 #include <string>
+#include <memory>
 #include "TTree.h"
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/stream/EDAnalyzer.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/Utilities/interface/InputTag.h"
@@ -12,6 +13,7 @@
 #include "CommonTools/UtilAlgos/interface/TFileService.h"
 #include "DataFormats/Common/interface/TriggerResults.h"
 
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
 #include "UMDNTuple/UMDNTuple/interface/EventInfoProducer.h"
 #include "UMDNTuple/UMDNTuple/interface/ElectronProducer.h"
 #include "UMDNTuple/UMDNTuple/interface/GenParticleProducer.h"
@@ -22,35 +24,41 @@
 #include "UMDNTuple/UMDNTuple/interface/METProducer.h"
 #include "UMDNTuple/UMDNTuple/interface/METFilterProducer.h"
 #include "UMDNTuple/UMDNTuple/interface/TriggerProducer.h"
+#include "UMDNTuple/UMDNTuple/interface/NTupleWriter.h"
+#include "UMDNTuple/UMDNTuple/interface/EventSkim.h"
 
 
-class UMDNTuple : public edm::EDAnalyzer {
+// One instance of the module runs per stream, each with its own
+// producers and its own memory resident EventTree.  The output
+// trees are owned by the NTupleWriter shared by all streams
+class UMDNTuple : public edm::stream::EDAnalyzer<edm::GlobalCache<NTupleWriter> > {
 
 public:
   /// default constructor
-  explicit UMDNTuple(const edm::ParameterSet&);
+  explicit UMDNTuple(const edm::ParameterSet&, const NTupleWriter*);
   /// default destructor
   ~UMDNTuple(); 
 
+  /// create the writer shared by all streams
+  static std::unique_ptr<NTupleWriter> initializeGlobalCache(const edm::ParameterSet&);
+  static void globalEndJob(NTupleWriter*);
+
 private:
-  /// everything that needs to be done before the event loop
-  virtual void beginJob() ;
   /// everything that needs to be done during the event loop
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
-  /// everything that needs to be done after the event loop
-
-  virtual void endJob();
+  virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
 
-  virtual void endRun(edm::Run const& iRun, edm::EventSetup const&);
+  virtual void endRun(edm::Run const& iRun, edm::EventSetup const&) override;
 
   
 private :
   
+  // per-stream event tree, not attached to any file
   TTree *_myTree;
   TTree *_weightInfoTree;
   TTree *_trigInfoTree;
   TTree *_filterInfoTree;
 
+  EventContext       _context;
   EventInfoProducer  _eventProducer;
   GenParticleProducer  _genProducer;
   ElectronProducer _elecProducer;
@@ -61,6 +69,10 @@ private :
   METProducer      _metProducer;
   METFilterProducer  _metFilterProducer;
   TriggerProducer  _trigProducer;
+
+  // one skim per output of the writer
+  std::vector<EventSkim> _skims;
+  std::vector<bool> _passed;
   
   bool _produceEvent;
   bool _produceElecs;
@@ -0,0 +1,171 @@
+#include <sstream>
+#include <algorithm>
+#include "UMDNTuple/UMDNTuple/plugins/UMDPreselection.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Common/interface/TriggerNames.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+UMDPreselection::UMDPreselection( const edm::ParameterSet & iConfig ) :
+    _useElecs(false),
+    _useMuons(false),
+    _usePhots(false),
+    _trigger_idx(0)
+{
+
+    if( iConfig.exists( "requiredTriggers" ) ) {
+        _requiredTriggers = iConfig.getUntrackedParameter<std::vector<int> >("requiredTriggers");
+    }
+
+    if( !_requiredTriggers.empty() ) {
+
+        _trigToken = consumes<edm::TriggerResults>(
+                iConfig.getUntrackedParameter<edm::InputTag>("triggerTag"));
+
+        std::vector<std::string> trigMap =
+            iConfig.getUntrackedParameter<std::vector<std::string> >("triggerMap");
+
+        for( std::vector<std::string>::const_iterator itr = trigMap.begin();
+                itr != trigMap.end(); ++itr ) {
+            int trig_idx;
+
+            std::string::size_type sep_pos = itr->find(":");
+            std::string idx_str = itr->substr(0, sep_pos );
+            std::string trig_name = itr->substr(sep_pos+1, itr->size() );
+
+            std::stringstream idx_ss(idx_str);
+            idx_ss >> trig_idx;
+
+            _trigger_map[trig_name] = trig_idx;
+        }
+    }
+
+    if( iConfig.exists( "minObjects" ) ) {
+        std::vector<edm::ParameterSet> mins =
+            iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("minObjects");
+        for( std::vector<edm::ParameterSet>::const_iterator itr = mins.begin();
+                itr != mins.end(); ++itr ) {
+
+            Multiplicity mult;
+            mult.minPt = itr->getUntrackedParameter<double>("minPt");
+            mult.min = itr->getUntrackedParameter<int>("min");
+
+            std::vector<std::string> objects =
+                itr->getUntrackedParameter<std::vector<std::string> >("objects");
+            for( std::vector<std::string>::const_iterator oitr = objects.begin();
+                    oitr != objects.end(); ++oitr ) {
+                if(      *oitr == "electrons" ) { mult.objects.push_back( kElectron ); _useElecs = true; }
+                else if( *oitr == "muons"     ) { mult.objects.push_back( kMuon );     _useMuons = true; }
+                else if( *oitr == "photons"   ) { mult.objects.push_back( kPhoton );   _usePhots = true; }
+                else {
+                    throw cms::Exception("Configuration")
+                    << "Unknown preselection object " << *oitr << ", use electrons, muons or photons";
+                }
+            }
+            _multiplicities.push_back( mult );
+        }
+    }
+
+    if( _useElecs ) {
+        _elecToken = consumes<std::vector<pat::Electron> >(
+                iConfig.getUntrackedParameter<edm::InputTag>("electronTag"));
+    }
+    if( _useMuons ) {
+        _muonToken = consumes<std::vector<pat::Muon> >(
+                iConfig.getUntrackedParameter<edm::InputTag>("muonTag"));
+    }
+    if( _usePhots ) {
+        _photToken = consumes<std::vector<pat::Photon> >(
+                iConfig.getUntrackedParameter<edm::InputTag>("photonTag"));
+    }
+}
+
+template<class T>
+int UMDPreselection::count( const std::vector<T> &objects, float minPt ) {
+
+    int n = 0;
+    for( typename std::vector<T>::const_iterator itr = objects.begin();
+            itr != objects.end(); ++itr ) {
+        if( itr->pt() > minPt ) ++n;
+    }
+    return n;
+}
+
+bool UMDPreselection::passTriggers( const edm::Event & iEvent ) {
+
+    edm::Handle<edm::TriggerResults> triggers;
+    iEvent.getByToken( _trigToken, triggers );
+
+    const edm::TriggerNames & trigNames = iEvent.triggerNames( *triggers );
+    const edm::ParameterSetID & menu = trigNames.parameterSetID();
+
+    if( !_trigger_idx || menu != _trigger_menu ) {
+
+        std::map<edm::ParameterSetID, std::vector<unsigned> >::iterator citr =
+            _trigger_idx_cache.find( menu );
+
+        if( citr == _trigger_idx_cache.end() ) {
+
+            std::vector<unsigned> & idx = _trigger_idx_cache[menu];
+
+            for( unsigned i = 0; i < trigNames.size(); ++i ) {
+
+                // same version stripping as the TriggerProducer
+                const std::string & trigname = trigNames.triggerName(i);
+                std::string trigname_mod = trigname.substr( 0, trigname.find_last_of("_") );
+
+                std::map<std::string, int>::const_iterator mitr = _trigger_map.find( trigname_mod );
+                if( mitr == _trigger_map.end() ) continue;
+
+                if( std::find( _requiredTriggers.begin(), _requiredTriggers.end(),
+                               mitr->second ) != _requiredTriggers.end() ) {
+                    idx.push_back( i );
+                }
+            }
+            citr = _trigger_idx_cache.find( menu );
+        }
+
+        _trigger_idx = &citr->second;
+        _trigger_menu = menu;
+    }
+
+    for( std::vector<unsigned>::const_iterator itr = _trigger_idx->begin();
+            itr != _trigger_idx->end(); ++itr ) {
+        if( triggers->accept( *itr ) ) return true;
+    }
+    return false;
+}
+
+bool UMDPreselection::filter( edm::Event & iEvent, const edm::EventSetup & ) {
+
+    if( !_requiredTriggers.empty() && !passTriggers( iEvent ) ) return false;
+
+    if( _multiplicities.empty() ) return true;
+
+    edm::Handle<std::vector<pat::Electron> > electrons;
+    edm::Handle<std::vector<pat::Muon> > muons;
+    edm::Handle<std::vector<pat::Photon> > photons;
+
+    if( _useElecs ) iEvent.getByToken( _elecToken, electrons );
+    if( _useMuons ) iEvent.getByToken( _muonToken, muons );
+    if( _usePhots ) iEvent.getByToken( _photToken, photons );
+
+    for( std::vector<Multiplicity>::const_iterator itr = _multiplicities.begin();
+            itr != _multiplicities.end(); ++itr ) {
+
+        int n = 0;
+        for( std::vector<int>::const_iterator oitr = itr->objects.begin();
+                oitr != itr->objects.end(); ++oitr ) {
+            switch( *oitr ) {
+                case kElectron : n += count( *electrons, itr->minPt ); break;
+                case kMuon     : n += count( *muons, itr->minPt ); break;
+                case kPhoton   : n += count( *photons, itr->minPt ); break;
+            }
+        }
+        if( n < itr->min ) return false;
+    }
+
+    return true;
+}
+
+DEFINE_FWK_MODULE(UMDPreselection);
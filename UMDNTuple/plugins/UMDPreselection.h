@@ -0,0 +1,66 @@
+#ifndef UMDPRESELECTION_H
+#define UMDPRESELECTION_H
+#include <vector>
+#include <string>
+#include <map>
+#include "FWCore/Framework/interface/stream/EDFilter.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/PatCandidates/interface/Photon.h"
+#include "DataFormats/Provenance/interface/ParameterSetID.h"
+
+// Cheap event filter meant to run first in the path, before the
+// EGamma corrections and the MET filters.  It only reads the
+// TriggerResults and the multiplicities of the input pat objects
+//
+//  requiredTriggers : ids of the triggerMap, at least one must pass
+//  minObjects       : VPSet of { objects, minPt, min }, the number of
+//                     objects (electrons, muons, photons) above minPt
+//                     must be at least min.  All entries must pass
+//
+// The pt of the input objects is uncorrected, so the thresholds
+// should be looser than the ones applied in the ntuple
+class UMDPreselection : public edm::stream::EDFilter<> {
+
+    public :
+        explicit UMDPreselection( const edm::ParameterSet & );
+
+    private :
+
+        virtual bool filter( edm::Event &, const edm::EventSetup & ) override;
+
+        bool passTriggers( const edm::Event & );
+
+        enum ObjectType { kElectron, kMuon, kPhoton };
+
+        struct Multiplicity {
+            std::vector<int> objects;
+            float minPt;
+            int min;
+        };
+
+        template<class T>
+        static int count( const std::vector<T> &objects, float minPt );
+
+        edm::EDGetTokenT<edm::TriggerResults> _trigToken;
+        edm::EDGetTokenT<std::vector<pat::Electron> > _elecToken;
+        edm::EDGetTokenT<std::vector<pat::Muon> > _muonToken;
+        edm::EDGetTokenT<std::vector<pat::Photon> > _photToken;
+
+        std::map<std::string, int> _trigger_map;
+        std::vector<int> _requiredTriggers;
+        std::vector<Multiplicity> _multiplicities;
+        bool _useElecs;
+        bool _useMuons;
+        bool _usePhots;
+
+        // trigger indices of the required ids, per trigger menu
+        std::map<edm::ParameterSetID, std::vector<unsigned> > _trigger_idx_cache;
+        const std::vector<unsigned> *_trigger_idx;
+        edm::ParameterSetID _trigger_menu;
+
+};
+#endif
@@ -0,0 +1,179 @@
+#include <sstream>
+#include <algorithm>
+#include "UMDNTuple/UMDNTuple/plugins/UMDTableNTuple.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+// copy the values of a scalar column into its fixed size
+// leaf buffer, missing values are zero
+template<class T, class S>
+static void copyValues( std::vector<T> &buffer, const std::vector<S> &values ) {
+
+    const unsigned n = std::min( buffer.size(), values.size() );
+    for( unsigned i = 0; i < n; ++i ) buffer[i] = values[i];
+    std::fill( buffer.begin() + n, buffer.end(), T(0) );
+}
+
+UMDTableNTuple::UMDTableNTuple( const edm::ParameterSet & iConfig ) :
+    _myTree(0),
+    _booked(false),
+    _outputSettings( iConfig ),
+    _floatPrecision( iConfig )
+{
+    usesResource( "TFileService" );
+
+    edm::Service<TFileService> fs;
+    _myTree = fs->make<TTree>( "EventTree", "EventTree" );
+
+    std::vector<edm::InputTag> tables =
+        iConfig.getUntrackedParameter<std::vector<edm::InputTag> >("tables");
+
+    for( std::vector<edm::InputTag>::const_iterator itr = tables.begin();
+            itr != tables.end(); ++itr ) {
+        _tableTokens.push_back( consumes<UMDTable>( *itr ) );
+    }
+    _columns.resize( _tableTokens.size() );
+}
+
+UMDTableNTuple::~UMDTableNTuple() {
+
+    for( unsigned i = 0; i < _columns.size(); ++i ) {
+        for( unsigned j = 0; j < _columns[i].size(); ++j ) {
+            delete _columns[i][j];
+        }
+    }
+}
+
+void UMDTableNTuple::book( unsigned itable, const UMDTable & table ) {
+
+    const std::vector<UMDTableColumn> & columns = table.columns();
+
+    for( std::vector<UMDTableColumn>::const_iterator itr = columns.begin();
+            itr != columns.end(); ++itr ) {
+
+        OutputColumn *out = new OutputColumn();
+        out->type = itr->type;
+        out->scalar = itr->scalar;
+        out->mantissaBits = -1;
+        if( itr->type == UMDTableColumn::kFloat ) {
+            out->mantissaBits = _floatPrecision.mantissaBits( itr->name );
+        }
+        out->length = itr->length;
+        out->floats = 0;
+        out->doubles = 0;
+        out->ints = 0;
+        out->uints = 0;
+        out->bools = 0;
+        out->intVectors = 0;
+        out->ulongs = 0;
+
+        const std::string & name = itr->name;
+
+        if( itr->scalar ) {
+            // fixed size arrays are booked as name[length]
+            std::stringstream leaf;
+            leaf << name;
+            if( out->length != 1 ) leaf << "[" << out->length << "]";
+            const std::string leaflist = leaf.str();
+            switch( itr->type ) {
+                case UMDTableColumn::kFloat   : out->floatValues .assign( out->length, 0 );
+                                                _myTree->Branch( name.c_str(), &out->floatValues [0], (leaflist + "/F").c_str() ); break;
+                case UMDTableColumn::kDouble  : out->doubleValues.assign( out->length, 0 );
+                                                _myTree->Branch( name.c_str(), &out->doubleValues[0], (leaflist + "/D").c_str() ); break;
+                case UMDTableColumn::kInt     : out->intValues   .assign( out->length, 0 );
+                                                _myTree->Branch( name.c_str(), &out->intValues   [0], (leaflist + "/I").c_str() ); break;
+                case UMDTableColumn::kUInt    : out->uintValues  .assign( out->length, 0 );
+                                                _myTree->Branch( name.c_str(), &out->uintValues  [0], (leaflist + "/i").c_str() ); break;
+                case UMDTableColumn::kBool    : out->boolValues  .assign( out->length, 0 );
+                                                _myTree->Branch( name.c_str(), &out->boolValues  [0], (leaflist + "/O").c_str() ); break;
+                case UMDTableColumn::kULong64 : out->ulongValues .assign( out->length, 0 );
+                                                _myTree->Branch( name.c_str(), &out->ulongValues [0], (leaflist + "/l").c_str() ); break;
+                default :
+                    throw cms::Exception("Configuration")
+                    << "Column " << name << " has an unknown scalar type " << itr->type;
+            }
+        }
+        else {
+            switch( itr->type ) {
+                case UMDTableColumn::kFloat     : _myTree->Branch( name.c_str(), &out->floats ); break;
+                case UMDTableColumn::kDouble    : _myTree->Branch( name.c_str(), &out->doubles ); break;
+                case UMDTableColumn::kInt       : _myTree->Branch( name.c_str(), &out->ints ); break;
+                case UMDTableColumn::kUInt      : _myTree->Branch( name.c_str(), &out->uints ); break;
+                case UMDTableColumn::kBool      : _myTree->Branch( name.c_str(), &out->bools ); break;
+                case UMDTableColumn::kIntVector : _myTree->Branch( name.c_str(), &out->intVectors ); break;
+                case UMDTableColumn::kULong64   : _myTree->Branch( name.c_str(), &out->ulongs ); break;
+                default :
+                    throw cms::Exception("Configuration")
+                    << "Column " << name << " has an unknown type " << itr->type;
+            }
+        }
+
+        _columns[itable].push_back( out );
+    }
+}
+
+void UMDTableNTuple::analyze( const edm::Event & iEvent, const edm::EventSetup & ) {
+
+    std::vector<edm::Handle<UMDTable> > tables( _tableTokens.size() );
+    for( unsigned i = 0; i < _tableTokens.size(); ++i ) {
+        iEvent.getByToken( _tableTokens[i], tables[i] );
+    }
+
+    if( !_booked ) {
+        for( unsigned i = 0; i < tables.size(); ++i ) {
+            book( i, *tables[i] );
+        }
+        _outputSettings.apply( _myTree );
+        _booked = true;
+    }
+
+    for( unsigned i = 0; i < tables.size(); ++i ) {
+
+        const std::vector<UMDTableColumn> & columns = tables[i]->columns();
+        if( columns.size() != _columns[i].size() ) {
+            throw cms::Exception("Configuration")
+            << "Table " << i << " changed its columns during the job";
+        }
+
+        for( unsigned j = 0; j < columns.size(); ++j ) {
+
+            const UMDTableColumn & in = columns[j];
+            OutputColumn *out = _columns[i][j];
+
+            if( out->scalar ) {
+                switch( out->type ) {
+                    case UMDTableColumn::kFloat   : copyValues( out->floatValues , in.floats );
+                                                    FloatPrecision::truncate( &out->floatValues[0], out->length, out->mantissaBits ); break;
+                    case UMDTableColumn::kDouble  : copyValues( out->doubleValues, in.doubles ); break;
+                    case UMDTableColumn::kInt     : copyValues( out->intValues   , in.ints ); break;
+                    case UMDTableColumn::kUInt    : copyValues( out->uintValues  , in.uints ); break;
+                    case UMDTableColumn::kBool    : copyValues( out->boolValues  , in.bools ); break;
+                    case UMDTableColumn::kULong64 : copyValues( out->ulongValues , in.ulongs ); break;
+                }
+            }
+            else {
+                switch( out->type ) {
+                    case UMDTableColumn::kFloat     : *out->floats     = in.floats;
+                                                      if( !out->floats->empty() ) {
+                                                          FloatPrecision::truncate( &(*out->floats)[0], out->floats->size(), out->mantissaBits );
+                                                      }
+                                                      break;
+                    case UMDTableColumn::kDouble    : *out->doubles    = in.doubles; break;
+                    case UMDTableColumn::kInt       : *out->ints       = in.ints; break;
+                    case UMDTableColumn::kUInt      : *out->uints      = in.uints; break;
+                    case UMDTableColumn::kBool      : *out->bools      = in.bools; break;
+                    case UMDTableColumn::kIntVector : *out->intVectors = in.intVectors; break;
+                    case UMDTableColumn::kULong64   : *out->ulongs     = in.ulongs; break;
+                }
+            }
+        }
+    }
+
+    _myTree->Fill();
+}
+
+DEFINE_FWK_MODULE(UMDTableNTuple);
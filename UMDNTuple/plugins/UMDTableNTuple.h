@@ -0,0 +1,60 @@
+#ifndef UMDTABLENTUPLE_H
+#define UMDTABLENTUPLE_H
+#include <vector>
+#include <string>
+#include "TTree.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "UMDNTuple/UMDNTuple/interface/UMDTable.h"
+#include "UMDNTuple/UMDNTuple/interface/TreeOutputSettings.h"
+#include "UMDNTuple/UMDNTuple/interface/FloatPrecision.h"
+
+// Writes the configured UMDTable products to the EventTree.
+// The branches are booked from the columns of the first event
+class UMDTableNTuple : public edm::one::EDAnalyzer<edm::one::SharedResources> {
+
+    public :
+        explicit UMDTableNTuple( const edm::ParameterSet & );
+        ~UMDTableNTuple();
+
+    private :
+
+        virtual void analyze( const edm::Event &, const edm::EventSetup & ) override;
+
+        struct OutputColumn {
+            int type;
+            bool scalar;
+            unsigned length;
+            int mantissaBits;
+
+            std::vector<float> *floats;
+            std::vector<double> *doubles;
+            std::vector<int> *ints;
+            std::vector<unsigned> *uints;
+            std::vector<bool> *bools;
+            std::vector<std::vector<int> > *intVectors;
+            std::vector<ULong64_t> *ulongs;
+
+            // leaf buffers of scalar columns, length values each.
+            // They are sized when booked and never resized
+            std::vector<float> floatValues;
+            std::vector<double> doubleValues;
+            std::vector<int> intValues;
+            std::vector<unsigned> uintValues;
+            std::vector<Bool_t> boolValues;
+            std::vector<ULong64_t> ulongValues;
+        };
+
+        void book( unsigned itable, const UMDTable & );
+
+        std::vector<edm::EDGetTokenT<UMDTable> > _tableTokens;
+        std::vector<std::vector<OutputColumn*> > _columns;
+
+        TTree *_myTree;
+        bool _booked;
+
+        TreeOutputSettings _outputSettings;
+        FloatPrecision _floatPrecision;
+
+};
+#endif
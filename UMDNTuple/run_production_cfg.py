@@ -11,6 +11,12 @@ opt = VarParsing.VarParsing ('analysis')
 opt.register('isMC', -1, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.int, 'Flag indicating if the input samples are from MC (1) or from the detector (0).')
 opt.register('nEvents', 1000, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.int, 'Number of events to analyze')
 opt.register('disableEventWeights', 0, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.bool, 'Set to 1 to disable event weights')
+opt.register('arrayBranches', 0, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.bool, 'Write object columns as arrays, el_pt[el_n], instead of std::vector')
+opt.register('packIdBits', 0, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.bool, 'Pack the boolean flags of each object into one <prefix>_idWord')
+opt.register('triggerBitmask', 0, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.bool, 'Write passing triggers and MET filters as bitmasks indexed by id')
+opt.register('preselect', 0, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.bool, 'Run the UMDPreselection filter before the EGamma corrections')
+opt.register('timing', 0, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.bool, 'Print the average time per event of each module at the end of the job')
+opt.register('nThreads', 1, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.int, 'Number of threads (and streams) used by cmsRun')
 
 #input files. Can be changed on the command line with the option inputFiles=...
 opt.inputFiles = [
@@ -75,8 +81,18 @@ process.TFileService = cms.Service("TFileService",
 process.load("FWCore.MessageLogger.MessageLogger_cfi")
 process.MessageLogger.cerr.FwkReport.reportEvery = 1000
 #process.MessageLogger.suppressWarning = cms.untracked.vstring('ecalLaserCorrFilter','manystripclus53X','toomanystripclus53X')
-process.options = cms.untracked.PSet( wantSummary = cms.untracked.bool(True) )
+process.options = cms.untracked.PSet( wantSummary = cms.untracked.bool(True),
+                                      numberOfThreads = cms.untracked.uint32( opt.nThreads ),
+                                      numberOfStreams = cms.untracked.uint32( 0 ), # one stream per thread
+)
 #process.options.allowUnscheduled = cms.untracked.bool(True)
+
+# per module timing, to compare two builds on the same input
+if opt.timing :
+    process.Timing = cms.Service("Timing",
+                                 summaryOnly = cms.untracked.bool(True),
+                                 useJobReport = cms.untracked.bool(True),
+    )
 #-----------------------------------------------------
 
 # Load the standard set of configuration modules
@@ -329,8 +345,85 @@ process.UMDNTuple = cms.EDAnalyzer("UMDNTuple",
     photonDetailLevel = cms.untracked.int32( 1 ),
     muonDetailLevel = cms.untracked.int32( 1 ),
     jetDetailLevel = cms.untracked.int32( 1 ),
+    # branch name globs of the EventTree.  Dropped object columns
+    # are also not computed, with outputs the union of their lists is used
+    #keep = cms.untracked.vstring("*"),
+    #drop = cms.untracked.vstring("el_*Iso*", "jet_bTag*", "fjet_ak08_Puppi_*"),
     isMC = cms.untracked.int32( opt.isMC ),
     disableEventWeights = cms.untracked.bool( opt.disableEventWeights ),
+    arrayBranches = cms.untracked.bool( opt.arrayBranches ),
+    packIdBits = cms.untracked.bool( opt.packIdBits ),
+    triggerBitmask = cms.untracked.bool( opt.triggerBitmask ),
+    # storage of the triggers passed by each HLT object : nested, csr or bitmask
+    hltObjLayout = cms.untracked.string("nested"),
+    # mantissa bits kept for float columns, 23 is full precision
+    #floatPrecision = cms.untracked.VPSet(
+    #    cms.PSet( branches = cms.untracked.vstring("*_eta", "*_phi", "*_sc_eta", "ph_r9", "ph_etaWidth", "ph_phiWidth"),
+    #              mantissaBits = cms.untracked.int32( 12 ) ),
+    #    cms.PSet( branches = cms.untracked.vstring("*Iso*", "*SumEt", "*SumPt"),
+    #              mantissaBits = cms.untracked.int32( 10 ) ),
+    #),
+    # compression, basket size and AutoFlush per tree and per
+    # group of branches.  autoFlush < 0 is the cluster size in bytes
+    #treeSettings = cms.untracked.VPSet(
+    #    cms.PSet( tree = cms.untracked.string("EventTree"),
+    #              compressionAlgorithm = cms.untracked.string("LZMA"),
+    #              compressionLevel = cms.untracked.int32( 4 ),
+    #              autoFlush = cms.untracked.int64( -30000000 ),
+    #              basketSize = cms.untracked.int32( 16000 ),
+    #              branchGroups = cms.untracked.VPSet(
+    #                  cms.PSet( branches = cms.untracked.vstring("*_n", "*_pt", "*_eta", "*_phi", "*_e"),
+    #                            compressionAlgorithm = cms.untracked.string("LZ4"),
+    #                            basketSize = cms.untracked.int32( 64000 ) ),
+    #              ),
+    #    ),
+    #),
+    # events are written only if every minObjects sum of counters
+    # reaches its min, any requiredTriggers id and all requiredFilters
+    # ids pass.  The counts are stored in the SkimInfoTree
+    #skim = cms.untracked.PSet(
+    #    minObjects = cms.untracked.VPSet(
+    #        cms.PSet( counters = cms.untracked.vstring("el_n", "mu_n"), min = cms.untracked.int32( 1 ) ),
+    #        cms.PSet( counters = cms.untracked.vstring("ph_n"), min = cms.untracked.int32( 1 ) ),
+    #    ),
+    #    requiredTriggers = cms.untracked.vint32( 0, 1 ),
+    #    requiredFilters = cms.untracked.vint32( 0 ),
+    #),
+    # write the EventTree to numbered files, ntuple_0.root, ntuple_1.root, ...
+    # of at most maxEvents events or about maxMB MB, each with all metadata trees.
+    # maxMB is approximate: it counts the written baskets plus the uncompressed
+    # baskets still in memory, the metadata trees come on top
+    #rollover = cms.untracked.PSet(
+    #    fileName = cms.untracked.string("ntuple"),
+    #    maxEvents = cms.untracked.int64( 100000 ),
+    #    maxMB = cms.untracked.double( 500 ),
+    #),
+    # compress the EventTree baskets on each stream and write them
+    # to ntuple_async.root from a background thread
+    #asyncOutput = cms.untracked.PSet(
+    #    fileName = cms.untracked.string("ntuple_async"),
+    #    flushEvents = cms.untracked.int32( 1000 ),
+    #),
+    # several outputs from one pass, each in its own directory with
+    # its own skim and branches.  Replaces the skim above
+    #outputs = cms.untracked.VPSet(
+    #    cms.PSet( name = cms.untracked.string("signal"),
+    #              skim = cms.untracked.PSet(
+    #                  minObjects = cms.untracked.VPSet(
+    #                      cms.PSet( counters = cms.untracked.vstring("ph_n"), min = cms.untracked.int32( 1 ) ),
+    #                  ),
+    #              ),
+    #    ),
+    #    cms.PSet( name = cms.untracked.string("control"),
+    #              skim = cms.untracked.PSet(
+    #                  minObjects = cms.untracked.VPSet(
+    #                      cms.PSet( counters = cms.untracked.vstring("el_n", "mu_n"), min = cms.untracked.int32( 2 ) ),
+    #                  ),
+    #              ),
+    #              keep = cms.untracked.vstring("*"),
+    #              drop = cms.untracked.vstring("jet_*", "fjet_*", "HLTObj*"),
+    #    ),
+    #),
     prefix_el   = cms.untracked.string("el"),
     prefix_mu   = cms.untracked.string("mu"),
     prefix_ph   = cms.untracked.string("ph"),
@@ -347,12 +440,35 @@ process.UMDNTuple = cms.EDAnalyzer("UMDNTuple",
     fjetMinPt = cms.untracked.double( 200 ),
     genMinPt = cms.untracked.double( 5 ),
 
+    # write the electrons and photons by decreasing corrected pt
+    #electronSortByPt = cms.untracked.bool( True ),
+    #photonSortByPt = cms.untracked.bool( True ),
+
 
 )
 
 
+# cheap preselection on the trigger results and the uncorrected
+# object multiplicities.  The @skipCurrentProcess tags read the
+# input collections, not the ones remade by egammaPostRecoSeq
+process.UMDPreselection = cms.EDFilter("UMDPreselection",
+    triggerTag  = cms.untracked.InputTag('TriggerResults', '', 'HLT'),
+    triggerMap = trigger_map,
+    #requiredTriggers = cms.untracked.vint32( 0, 1 ),
+    electronTag = cms.untracked.InputTag('slimmedElectrons', '', '@skipCurrentProcess'),
+    muonTag     = cms.untracked.InputTag('slimmedMuons', '', '@skipCurrentProcess'),
+    photonTag   = cms.untracked.InputTag('slimmedPhotons', '', '@skipCurrentProcess'),
+    # thresholds below the ntuple ones, the energy corrections are not applied yet
+    minObjects = cms.untracked.VPSet(
+        cms.PSet( objects = cms.untracked.vstring("electrons", "muons"),
+                  minPt = cms.untracked.double( 8 ),
+                  min = cms.untracked.int32( 1 ) ),
+    ),
+)
+
 process.p = cms.Path()
 
+if opt.preselect: process.p += process.UMDPreselection
 #process.p += process.selectedElectrons
 process.p += process.egammaPostRecoSeq
 # run additional MET filters
@@ -362,3 +478,14 @@ process.p += process.BadChargedCandidateFilter
 
 process.p += process.UMDNTuple
 
+# the object producers can also run as separate modules that put
+# UMDTable products into the event, written out by UMDTableNTuple
+#process.elecTable = cms.EDProducer("ElectronTableProducer", **process.UMDNTuple.parameters_())
+#process.muonTable = cms.EDProducer("MuonTableProducer", **process.UMDNTuple.parameters_())
+#process.tableNTuple = cms.EDAnalyzer("UMDTableNTuple",
+#    tables = cms.untracked.VInputTag("elecTable", "muonTable"),
+#)
+#process.p += process.elecTable
+#process.p += process.muonTable
+#process.p += process.tableNTuple
+
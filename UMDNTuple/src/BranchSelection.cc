@@ -0,0 +1,50 @@
+#include <fnmatch.h>
+#include "UMDNTuple/UMDNTuple/interface/BranchSelection.h"
+
+BranchSelection::BranchSelection()
+{
+}
+
+BranchSelection::BranchSelection( const edm::ParameterSet & iConfig ) {
+
+    Rule rule;
+    if( iConfig.exists( "keep" ) ) {
+        rule.keep = iConfig.getUntrackedParameter<std::vector<std::string> >("keep");
+    }
+    if( iConfig.exists( "drop" ) ) {
+        rule.drop = iConfig.getUntrackedParameter<std::vector<std::string> >("drop");
+    }
+    _rules.push_back( rule );
+}
+
+void BranchSelection::merge( const BranchSelection & other ) {
+
+    // an empty selection keeps everything
+    if( other._rules.empty() ) {
+        _rules.push_back( Rule() );
+        return;
+    }
+    _rules.insert( _rules.end(), other._rules.begin(), other._rules.end() );
+}
+
+bool BranchSelection::selected( const std::string &name ) const {
+
+    if( _rules.empty() ) return true;
+
+    for( std::vector<Rule>::const_iterator ritr = _rules.begin();
+            ritr != _rules.end(); ++ritr ) {
+
+        bool keep = ritr->keep.empty();
+        for( std::vector<std::string>::const_iterator itr = ritr->keep.begin();
+                itr != ritr->keep.end() && !keep; ++itr ) {
+            keep = ( fnmatch( itr->c_str(), name.c_str(), 0 ) == 0 );
+        }
+
+        for( std::vector<std::string>::const_iterator itr = ritr->drop.begin();
+                itr != ritr->drop.end() && keep; ++itr ) {
+            if( fnmatch( itr->c_str(), name.c_str(), 0 ) == 0 ) keep = false;
+        }
+        if( keep ) return true;
+    }
+    return false;
+}
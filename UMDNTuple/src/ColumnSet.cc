@@ -0,0 +1,86 @@
+#include "UMDNTuple/UMDNTuple/interface/ColumnSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+ColumnSet::ColumnSet() :
+    _tree(0),
+    _detail(99),
+    _n(0)
+{
+}
+
+ColumnSet::~ColumnSet() {
+
+    for( unsigned i = 0; i < _columns.size(); ++i ) {
+        delete _columns[i];
+    }
+    for( unsigned i = 0; i < _unbooked.size(); ++i ) {
+        delete _unbooked[i];
+    }
+}
+
+void ColumnSet::initialize( const std::string &prefix, TTree *tree, int detail,
+                            const BranchSelection &selection ) {
+
+    _prefix = prefix;
+    _tree = tree;
+    _detail = detail;
+    _selection = selection;
+
+    tree->Branch( (prefix + "_n" ).c_str(), &_n, (prefix + "_n/I" ).c_str() );
+
+}
+
+bool ColumnSet::booked( const void *values ) const {
+
+    for( std::vector<ColumnBase*>::const_iterator itr = _columns.begin();
+            itr != _columns.end(); ++itr ) {
+        if( (*itr)->address() == values ) return true;
+    }
+    return false;
+}
+
+void ColumnSet::clear() {
+
+    _n = 0;
+    for( std::vector<ColumnBase*>::const_iterator itr = _columns.begin();
+            itr != _columns.end(); ++itr ) {
+        (*itr)->clear();
+    }
+    for( std::vector<ColumnBase*>::const_iterator itr = _unbooked.begin();
+            itr != _unbooked.end(); ++itr ) {
+        (*itr)->clear();
+    }
+}
+
+void ColumnSet::reserve( size_t n ) {
+
+    for( std::vector<ColumnBase*>::const_iterator itr = _columns.begin();
+            itr != _columns.end(); ++itr ) {
+        (*itr)->reserve( n );
+    }
+}
+
+void ColumnSet::permute( const std::vector<unsigned> &order ) {
+
+    if( order.size() != static_cast<size_t>( _n ) ) {
+        throw cms::Exception("LogicError")
+        << "Permutation of " << order.size() << " objects for "
+        << _n << " " << _prefix << " objects";
+    }
+    for( std::vector<ColumnBase*>::const_iterator itr = _columns.begin();
+            itr != _columns.end(); ++itr ) {
+        (*itr)->permute( order );
+    }
+}
+
+void ColumnSet::endObject() {
+
+    ++_n;
+    for( std::vector<ColumnBase*>::const_iterator itr = _columns.begin();
+            itr != _columns.end(); ++itr ) {
+        if( !(*itr)->pad( _n ) ) {
+            throw cms::Exception("LogicError")
+            << "Column " << (*itr)->name << " was filled more than once for one object";
+        }
+    }
+}
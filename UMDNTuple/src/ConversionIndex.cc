@@ -0,0 +1,55 @@
+#include <algorithm>
+#include "UMDNTuple/UMDNTuple/interface/ConversionIndex.h"
+#include "DataFormats/EgammaCandidates/interface/Conversion.h"
+#include "RecoEgamma/EgammaTools/interface/ConversionTools.h"
+
+// selection used by hasMatchedConversion
+static const float convLxyMin = 2.0;
+static const float convProbMin = 1e-6;
+static const unsigned convNHitsBeforeVtxMax = 0;
+
+ConversionIndex::ConversionIndex()
+{
+}
+
+void ConversionIndex::build( const reco::ConversionCollection &conversions,
+                             const math::XYZPoint &beamspot ) {
+
+    _tracks.clear();
+
+    for( reco::ConversionCollection::const_iterator itr = conversions.begin();
+            itr != conversions.end(); ++itr ) {
+
+        if( !ConversionTools::isGoodConversion( *itr, beamspot, convLxyMin,
+                                                convProbMin, convNHitsBeforeVtxMax ) ) continue;
+
+        const std::vector<edm::RefToBase<reco::Track> > & tracks = itr->tracks();
+        for( std::vector<edm::RefToBase<reco::Track> >::const_iterator titr = tracks.begin();
+                titr != tracks.end(); ++titr ) {
+            _tracks.push_back( TrackKey( titr->id(), titr->key() ) );
+        }
+    }
+
+    std::sort( _tracks.begin(), _tracks.end() );
+    _tracks.erase( std::unique( _tracks.begin(), _tracks.end() ), _tracks.end() );
+}
+
+bool ConversionIndex::contains( const edm::ProductID &id, size_t key ) const {
+
+    return std::binary_search( _tracks.begin(), _tracks.end(), TrackKey( id, key ) );
+}
+
+bool ConversionIndex::matched( const reco::GsfElectron &ele ) const {
+
+    if( _tracks.empty() ) return false;
+
+    // the references of the reco electron, as in
+    // ConversionTools::matchesConversion
+    const reco::GsfTrackRef gsf = ele.reco::GsfElectron::gsfTrack();
+    if( gsf.isNonnull() && contains( gsf.id(), gsf.key() ) ) return true;
+
+    const reco::TrackRef ctf = ele.reco::GsfElectron::closestCtfTrackRef();
+    if( ctf.isNonnull() && contains( ctf.id(), ctf.key() ) ) return true;
+
+    return false;
+}
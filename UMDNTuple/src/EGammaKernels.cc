@@ -0,0 +1,114 @@
+#include <algorithm>
+#include "UMDNTuple/UMDNTuple/interface/EGammaKernels.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+void CalibratedKinematics::clear() {
+
+    _pt.clear();
+    _eta.clear();
+    _phi.clear();
+    _e.clear();
+    _scale.clear();
+    _scaledP4.clear();
+}
+
+void CalibratedKinematics::reserve( unsigned n ) {
+
+    _pt.reserve( n );
+    _eta.reserve( n );
+    _phi.reserve( n );
+    _e.reserve( n );
+    _scale.reserve( n );
+}
+
+void CalibratedKinematics::add( const reco::Candidate &cand, double calibratedEnergy ) {
+
+    _pt.push_back( cand.pt() );
+    _eta.push_back( cand.eta() );
+    _phi.push_back( cand.phi() );
+    _e.push_back( cand.energy() );
+    _scale.push_back( calibratedEnergy/cand.energy() );
+
+    if( !( _scale.back() > 0 ) ) {
+        _scaledP4.push_back( std::make_pair( _scale.size() - 1,
+                             cand.p4() * calibratedEnergy/cand.energy() ) );
+    }
+}
+
+void CalibratedKinematics::compute() {
+
+    const unsigned n = _scale.size();
+    _ptOut.resize( n );
+    _etaOut.resize( n );
+    _phiOut.resize( n );
+    _eOut.resize( n );
+
+    for( unsigned i = 0; i < n; ++i ) {
+        _ptOut[i]  = _pt[i]*_scale[i];
+        _etaOut[i] = _eta[i];
+        _phiOut[i] = _phi[i];
+        _eOut[i]   = _e[i]*_scale[i];
+    }
+
+    for( std::vector<std::pair<unsigned, reco::Candidate::LorentzVector> >::const_iterator itr = _scaledP4.begin();
+            itr != _scaledP4.end(); ++itr ) {
+        _ptOut[itr->first]  = itr->second.Pt();
+        _etaOut[itr->first] = itr->second.Eta();
+        _phiOut[itr->first] = itr->second.Phi();
+        _eOut[itr->first]   = itr->second.E();
+    }
+}
+
+namespace {
+    struct DecreasingPt {
+        const std::vector<double> &pt;
+        explicit DecreasingPt( const std::vector<double> &p ) : pt( p ) {}
+        bool operator()( unsigned a, unsigned b ) const { return pt[a] > pt[b]; }
+    };
+}
+
+bool CalibratedKinematics::ptOrder( std::vector<unsigned> &order ) const {
+
+    order.resize( _ptOut.size() );
+    for( unsigned i = 0; i < order.size(); ++i ) order[i] = i;
+
+    DecreasingPt decreasing( _ptOut );
+    if( std::is_sorted( order.begin(), order.end(), decreasing ) ) return false;
+
+    std::stable_sort( order.begin(), order.end(), decreasing );
+    return true;
+}
+
+CorrectedIsolation::CorrectedIsolation( unsigned nIso ) :
+    _nIso( nIso )
+{
+}
+
+void CorrectedIsolation::clear() {
+
+    _iso.clear();
+}
+
+void CorrectedIsolation::reserve( unsigned n ) {
+
+    _iso.reserve( n*_nIso );
+}
+
+void CorrectedIsolation::add( const float *iso ) {
+
+    _iso.insert( _iso.end(), iso, iso + _nIso );
+}
+
+void CorrectedIsolation::compute( const std::vector<float> &areas, double rho ) {
+
+    if( areas.size() != _iso.size() ) {
+        throw cms::Exception("LogicError")
+        << "Expected " << _iso.size() << " effective areas, got " << areas.size();
+    }
+
+    const unsigned n = _iso.size();
+    _corrected.resize( n );
+    for( unsigned i = 0; i < n; ++i ) {
+        _corrected[i] = std::max( 0.0, _iso[i] - rho*areas[i] );
+    }
+}
@@ -0,0 +1,112 @@
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "UMDNTuple/UMDNTuple/interface/EffectiveAreaTable.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+EffectiveAreaTable::EffectiveAreaTable( const std::vector<std::string> &files ) :
+    _nAreas( files.size() )
+{
+
+    std::vector<std::vector<float> > values;
+
+    for( std::vector<std::string>::const_iterator itr = files.begin();
+            itr != files.end(); ++itr ) {
+
+        edm::FileInPath path( *itr );
+        std::ifstream input( path.fullPath().c_str() );
+        if( !input ) {
+            throw cms::Exception("Configuration")
+            << "Could not open effective area file " << path.fullPath();
+        }
+
+        std::vector<float> absEtaMin;
+        std::vector<float> absEtaMax;
+        values.push_back( std::vector<float>() );
+
+        std::string line;
+        while( std::getline( input, line ) ) {
+            if( line.empty() || line[0] == '#' ) continue;
+            std::stringstream ss( line );
+            float etaMin, etaMax, area;
+            if( !( ss >> etaMin >> etaMax >> area ) ) continue;
+            absEtaMin.push_back( etaMin );
+            absEtaMax.push_back( etaMax );
+            values.back().push_back( area );
+        }
+
+        // bins must be ordered and must not overlap
+        for( unsigned i = 0; i < absEtaMin.size(); ++i ) {
+            if( absEtaMin[i] >= absEtaMax[i] || ( i > 0 && absEtaMin[i] < absEtaMax[i-1] ) ) {
+                throw cms::Exception("Configuration")
+                << "Inconsistent |eta| bins in effective area file " << path.fullPath();
+            }
+        }
+
+        if( itr == files.begin() ) {
+            _absEtaMin = absEtaMin;
+            _absEtaMax = absEtaMax;
+        }
+        else if( absEtaMin != _absEtaMin || absEtaMax != _absEtaMax ) {
+            throw cms::Exception("Configuration")
+            << "The |eta| bins of effective area file " << path.fullPath()
+            << " differ from those of " << files.front();
+        }
+    }
+
+    for( unsigned i = 0; i < _absEtaMin.size(); ++i ) {
+        for( unsigned j = 0; j < _nAreas; ++j ) {
+            _areas.push_back( values[j][i] );
+        }
+    }
+    _areas.insert( _areas.end(), _nAreas, 0. );
+
+}
+
+const EffectiveAreaTable & EffectiveAreaTable::electrons() {
+
+    static const EffectiveAreaTable table( std::vector<std::string>( 1,
+        "UMDNTuple/UMDNTuple/data/effAreaElectrons_cone03_pfNeuHadronsAndPhotons_94X.txt" ) );
+    return table;
+}
+
+const EffectiveAreaTable & EffectiveAreaTable::photons() {
+
+    static const char * files[] = {
+        "UMDNTuple/UMDNTuple/data/effAreaPhotons_cone03_pfChargedHadrons_90percentBased_V2.txt",
+        "UMDNTuple/UMDNTuple/data/effAreaPhotons_cone03_pfNeutralHadrons_90percentBased_V2.txt",
+        "UMDNTuple/UMDNTuple/data/effAreaPhotons_cone03_pfPhotons_90percentBased_V2.txt"
+    };
+    static const EffectiveAreaTable table( std::vector<std::string>( files, files + 3 ) );
+    return table;
+}
+
+int EffectiveAreaTable::bin( float absEta ) const {
+
+    // count the lower edges below absEta, this
+    // loop has no branches and is vectorized
+    int idx = -1;
+    for( unsigned i = 0; i < _absEtaMin.size(); ++i ) {
+        idx += ( absEta >= _absEtaMin[i] );
+    }
+    if( idx < 0 || !( absEta < _absEtaMax[idx] ) ) return _absEtaMin.size();
+    return idx;
+}
+
+const float * EffectiveAreaTable::areas( float absEta ) const {
+
+    return &_areas[ bin( absEta )*_nAreas ];
+}
+
+void EffectiveAreaTable::areas( const std::vector<float> &absEta, std::vector<float> &result ) const {
+
+    result.resize( absEta.size()*_nAreas );
+
+    std::vector<float>::iterator out = result.begin();
+    for( std::vector<float>::const_iterator itr = absEta.begin();
+            itr != absEta.end(); ++itr ) {
+        const float *row = areas( *itr );
+        out = std::copy( row, row + _nAreas, out );
+    }
+}
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include "UMDNTuple/UMDNTuple/interface/EventContext.h"
+#include "DataFormats/EgammaCandidates/interface/Conversion.h"
+
+EventContext::EventContext() :
+    _firstVertex(0),
+    _primaryVertex(0),
+    _rhoPrime(0)
+{
+}
+
+void EventContext::initialize( const edm::EDGetTokenT<std::vector<reco::Vertex> > &vertexTok,
+                               const edm::EDGetTokenT<double> &rhoTok,
+                               const edm::EDGetTokenT<reco::BeamSpot> &beamSpotTok,
+                               const edm::EDGetTokenT<reco::ConversionCollection> &conversionsTok ) {
+
+    _vertexToken = vertexTok;
+    _rhoToken = rhoTok;
+    _beamSpotToken = beamSpotTok;
+    _conversionsToken = conversionsTok;
+}
+
+void EventContext::fill( const edm::Event &iEvent ) {
+
+    _firstVertex = 0;
+    _primaryVertex = 0;
+    _rhoPrime = 0;
+
+    if( !_vertexToken.isUninitialized() ) {
+        iEvent.getByToken( _vertexToken, _vertices );
+        if( _vertices.isValid() && !_vertices->empty() ) {
+            _firstVertex = &_vertices->front();
+            if( !_firstVertex->isFake() ) _primaryVertex = _firstVertex;
+        }
+    }
+    if( !_rhoToken.isUninitialized() ) {
+        iEvent.getByToken( _rhoToken, _rho );
+        if( _rho.isValid() ) _rhoPrime = std::max( 0., *_rho );
+    }
+    if( !_beamSpotToken.isUninitialized() ) {
+        iEvent.getByToken( _beamSpotToken, _beamSpot );
+    }
+    if( !_conversionsToken.isUninitialized() ) {
+        iEvent.getByToken( _conversionsToken, _conversions );
+    }
+}
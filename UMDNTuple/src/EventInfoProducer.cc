@@ -27,23 +27,19 @@ EventInfoProducer::EventInfoProducer(  ) :
 }
 
 void EventInfoProducer::initialize( 
-                        const edm::EDGetTokenT<std::vector<reco::Vertex> > & vtxTok, 
                         const edm::EDGetTokenT<std::vector<PileupSummaryInfo> > & puTok,
                         const edm::EDGetTokenT<GenEventInfoProduct> & genTok,
                         const edm::EDGetTokenT<LHEEventProduct> & lheEventTok, 
                         const edm::EDGetTokenT<LHERunInfoProduct> & lheRunTok, 
-                        const edm::EDGetTokenT<double> & rhoTok, 
                         const edm::EDGetTokenT< double >&prefTok,
                         const edm::EDGetTokenT< double >&prefupTok,
                         const edm::EDGetTokenT< double >&prefdownTok,
                         TTree *tree, TTree *infoTree, bool isMC, bool doPref) {
 
-    _vertexToken = vtxTok;
     _puToken = puTok;
     _generatorToken = genTok;
     _lheEventToken = lheEventTok;
     _lheRunToken = lheRunTok;
-    _rhoToken = rhoTok;
     _prefweight_token = prefTok;
     _prefweightup_token = prefupTok;
     _prefweightdown_token = prefdownTok;
@@ -80,7 +76,7 @@ void EventInfoProducer::initialize(
 }
 
 
-void EventInfoProducer::produce(const edm::Event &iEvent ) {
+void EventInfoProducer::produce(const edm::Event &iEvent, const EventContext &context ) {
 
     vtx_n = 0;
     pu_n = 0;
@@ -100,12 +96,7 @@ void EventInfoProducer::produce(const edm::Event &iEvent ) {
         EventWeights->clear();
     }
 
-    edm::Handle<std::vector<reco::Vertex> > vertices_h;
-    iEvent.getByToken(_vertexToken, vertices_h);
-
-
-    edm::Handle<double>   rho_h;
-    iEvent.getByToken(_rhoToken, rho_h);
+    const edm::Handle<std::vector<reco::Vertex> > & vertices_h = context.vertices();
 
     if (_isMC && _doPref ){
        edm::Handle< double > theprefweight;
@@ -130,7 +121,7 @@ void EventInfoProducer::produce(const edm::Event &iEvent ) {
         if (vtx->isValid() && !vtx->isFake()) vtx_n++;
     }
 
-    rho = (*rho_h);
+    rho = context.rho();
 
     if( _isMC ) {
         edm::Handle<std::vector< PileupSummaryInfo > >  pileup_h;
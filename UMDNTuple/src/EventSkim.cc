@@ -0,0 +1,89 @@
+#include <algorithm>
+#include "UMDNTuple/UMDNTuple/interface/EventSkim.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "TBranch.h"
+#include "TBranchElement.h"
+#include "TLeaf.h"
+
+EventSkim::EventSkim() {
+
+}
+
+EventSkim::EventSkim( const edm::ParameterSet & iConfig ) {
+
+    if( !iConfig.exists( "skim" ) ) return;
+
+    edm::ParameterSet skim = iConfig.getUntrackedParameter<edm::ParameterSet>("skim");
+
+    if( skim.exists( "minObjects" ) ) {
+        std::vector<edm::ParameterSet> mins =
+            skim.getUntrackedParameter<std::vector<edm::ParameterSet> >("minObjects");
+        for( std::vector<edm::ParameterSet>::const_iterator itr = mins.begin();
+                itr != mins.end(); ++itr ) {
+            Multiplicity mult;
+            mult.names = itr->getUntrackedParameter<std::vector<std::string> >("counters");
+            mult.min = itr->getUntrackedParameter<int>("min");
+            _multiplicities.push_back( mult );
+        }
+    }
+    if( skim.exists( "requiredTriggers" ) ) {
+        _requiredTriggers = skim.getUntrackedParameter<std::vector<int> >("requiredTriggers");
+    }
+    if( skim.exists( "requiredFilters" ) ) {
+        _requiredFilters = skim.getUntrackedParameter<std::vector<int> >("requiredFilters");
+    }
+}
+
+void EventSkim::bind( TTree *tree ) {
+
+    for( std::vector<Multiplicity>::iterator itr = _multiplicities.begin();
+            itr != _multiplicities.end(); ++itr ) {
+
+        itr->counters.clear();
+        for( std::vector<std::string>::const_iterator nitr = itr->names.begin();
+                nitr != itr->names.end(); ++nitr ) {
+
+            TBranch *branch = tree->GetBranch( nitr->c_str() );
+            TLeaf *leaf = branch ? branch->GetLeaf( nitr->c_str() ) : 0;
+            if( !leaf || dynamic_cast<TBranchElement*>( branch )
+                      || std::string( leaf->GetTypeName() ) != "Int_t" ) {
+                throw cms::Exception("Configuration")
+                << "Skim counter " << *nitr << " is not an object counter of the EventTree";
+            }
+            itr->counters.push_back( reinterpret_cast<const int*>( branch->GetAddress() ) );
+        }
+    }
+}
+
+bool EventSkim::pass( const std::vector<int> &triggers,
+                      const std::vector<int> &filters ) const {
+
+    for( std::vector<Multiplicity>::const_iterator itr = _multiplicities.begin();
+            itr != _multiplicities.end(); ++itr ) {
+        int sum = 0;
+        for( std::vector<const int*>::const_iterator citr = itr->counters.begin();
+                citr != itr->counters.end(); ++citr ) {
+            sum += **citr;
+        }
+        if( sum < itr->min ) return false;
+    }
+
+    if( !_requiredTriggers.empty() ) {
+        bool passTrig = false;
+        for( std::vector<int>::const_iterator itr = _requiredTriggers.begin();
+                itr != _requiredTriggers.end(); ++itr ) {
+            if( std::find( triggers.begin(), triggers.end(), *itr ) != triggers.end() ) {
+                passTrig = true;
+                break;
+            }
+        }
+        if( !passTrig ) return false;
+    }
+
+    for( std::vector<int>::const_iterator itr = _requiredFilters.begin();
+            itr != _requiredFilters.end(); ++itr ) {
+        if( std::find( filters.begin(), filters.end(), *itr ) == filters.end() ) return false;
+    }
+
+    return true;
+}
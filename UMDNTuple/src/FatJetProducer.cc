@@ -2,97 +2,91 @@
 #include "FWCore/Framework/interface/EDConsumerBase.h"
 #include "FWCore/Framework/interface/Event.h"
 
-FatJetProducer::FatJetProducer(  ) : 
-    jet_ak08_prunedMass(0),
-    //jet_ak08_FilteredMass(0),
-    jet_ak08_SoftDropMass(0),
-    jet_ak08_Puppi_SoftDropMass(0),
-    jet_ak08_TrimmedMass(0),
-    jet_ak08_tau1(0),
-    jet_ak08_tau2(0),
-    jet_ak08_tau3(0),
-    jet_ak08_Puppi_tau1(0),
-    jet_ak08_Puppi_tau2(0),
-    jet_ak08_Puppi_tau3(0)
+FatJetProducer::FatJetProducer(  )
 {
 
 }
 
 void FatJetProducer::initialize( const std::string &prefix,
                                  const edm::EDGetTokenT<edm::View<pat::Jet> >&jetTok,
-                                 TTree *tree, float minPt) {
+                                 TTree *tree, float minPt,
+                                 const BranchSelection &selection ) {
 
     _prefix = prefix;
     _jetToken = jetTok;
     _minPt = minPt;
 
-    tree->Branch( (prefix + "_ak08_prunedMass" ).c_str(), &jet_ak08_prunedMass );
-    //tree->Branch( (prefix + "_ak08_FilteredMass" ).c_str(), &jet_ak08_FilteredMass );
-    tree->Branch( (prefix + "_ak08_SoftDropMass" ).c_str(), &jet_ak08_SoftDropMass );
-    tree->Branch( (prefix + "_ak08_Puppi_SoftDropMass" ).c_str(), &jet_ak08_Puppi_SoftDropMass );
-    tree->Branch( (prefix + "_ak08_TrimmedMass" ).c_str(), &jet_ak08_TrimmedMass );
-    tree->Branch( (prefix + "_ak08_tau1" ).c_str(), &jet_ak08_tau1 );
-    tree->Branch( (prefix + "_ak08_tau2" ).c_str(), &jet_ak08_tau2 );
-    tree->Branch( (prefix + "_ak08_tau3" ).c_str(), &jet_ak08_tau3 );
-    tree->Branch( (prefix + "_ak08_Puppi_tau1" ).c_str(), &jet_ak08_Puppi_tau1 );
-    tree->Branch( (prefix + "_ak08_Puppi_tau2" ).c_str(), &jet_ak08_Puppi_tau2 );
-    tree->Branch( (prefix + "_ak08_Puppi_tau3" ).c_str(), &jet_ak08_Puppi_tau3 );
-
-
+    _columns.initialize( prefix, tree, 99, selection );
+
+    jet_ak08_prunedMass         = _columns.add<float>( "ak08_prunedMass" );
+    //jet_ak08_FilteredMass       = _columns.add<float>( "ak08_FilteredMass" );
+    jet_ak08_SoftDropMass       = _columns.add<float>( "ak08_SoftDropMass" );
+    jet_ak08_Puppi_SoftDropMass = _columns.add<float>( "ak08_Puppi_SoftDropMass" );
+    // trimmed mass is not stored in miniAOD
+    //jet_ak08_TrimmedMass        = _columns.add<float>( "ak08_TrimmedMass" );
+    jet_ak08_tau1       = _columns.add<float>( "ak08_tau1" );
+    jet_ak08_tau2       = _columns.add<float>( "ak08_tau2" );
+    jet_ak08_tau3       = _columns.add<float>( "ak08_tau3" );
+    jet_ak08_Puppi_tau1 = _columns.add<float>( "ak08_Puppi_tau1" );
+    jet_ak08_Puppi_tau2 = _columns.add<float>( "ak08_Puppi_tau2" );
+    jet_ak08_Puppi_tau3 = _columns.add<float>( "ak08_Puppi_tau3" );
+
+    //Available user floats :
+    //NjettinessAK8Puppi:tau1
+    //NjettinessAK8Puppi:tau2
+    //NjettinessAK8Puppi:tau3
+    //ak8PFJetsCHSValueMap:NjettinessAK8CHSTau1
+    //ak8PFJetsCHSValueMap:NjettinessAK8CHSTau2
+    //ak8PFJetsCHSValueMap:NjettinessAK8CHSTau3
+    //ak8PFJetsCHSValueMap:ak8PFJetsCHSPrunedMass
+    //ak8PFJetsCHSValueMap:ak8PFJetsCHSSoftDropMass
+    //ak8PFJetsCHSValueMap:eta
+    //ak8PFJetsCHSValueMap:mass
+    //ak8PFJetsCHSValueMap:phi
+    //ak8PFJetsCHSValueMap:pt
+    //ak8PFJetsPuppiSoftDropMass
+
+    _userFloats.clear();
+    addUserFloat( jet_ak08_prunedMass        , "ak8PFJetsCHSValueMap:ak8PFJetsCHSPrunedMass" );
+    addUserFloat( jet_ak08_SoftDropMass      , "ak8PFJetsCHSValueMap:ak8PFJetsCHSSoftDropMass" );
+    addUserFloat( jet_ak08_Puppi_SoftDropMass, "ak8PFJetsPuppiSoftDropMass" );
+    addUserFloat( jet_ak08_tau1      , "ak8PFJetsCHSValueMap:NjettinessAK8CHSTau1" );
+    addUserFloat( jet_ak08_tau2      , "ak8PFJetsCHSValueMap:NjettinessAK8CHSTau2" );
+    addUserFloat( jet_ak08_tau3      , "ak8PFJetsCHSValueMap:NjettinessAK8CHSTau3" );
+    addUserFloat( jet_ak08_Puppi_tau1, "NjettinessAK8Puppi:tau1" );
+    addUserFloat( jet_ak08_Puppi_tau2, "NjettinessAK8Puppi:tau2" );
+    addUserFloat( jet_ak08_Puppi_tau3, "NjettinessAK8Puppi:tau3" );
+}
 
+void FatJetProducer::addUserFloat( std::vector<float> *column, const std::string &userFloat ) {
 
+    // dropped columns are not looked up
+    if( _columns.booked( column ) ) {
+        _userFloats.push_back( std::make_pair( column, userFloat ) );
+    }
 }
 
 
-void FatJetProducer::produce(const edm::Event &iEvent ) {
+void FatJetProducer::produce(const edm::Event &iEvent, const EventContext & ) {
 
-    jet_ak08_prunedMass->clear();
-    //jet_ak08_FilteredMass->clear();
-    jet_ak08_SoftDropMass->clear();
-    jet_ak08_Puppi_SoftDropMass->clear();
-    jet_ak08_TrimmedMass->clear();
-    jet_ak08_tau1->clear();
-    jet_ak08_tau2->clear();
-    jet_ak08_tau3->clear();
-    jet_ak08_Puppi_tau1->clear();
-    jet_ak08_Puppi_tau2->clear();
-    jet_ak08_Puppi_tau3->clear();
+    _columns.clear();
 
     //_jetProducer.produce( iEvent );
 
     iEvent.getByToken(_jetToken,jets);
+    _columns.reserve( jets->size() );
 
     for (unsigned int j=0; j < jets->size();++j){
-        edm::Ptr<pat::Jet> jet = jets->ptrAt(j);
+        const pat::Jet & jet = jets->at(j);
  
-        if( jet->pt() < _minPt ) continue;
-
-        jet_ak08_prunedMass -> push_back( jet->userFloat("ak8PFJetsCHSValueMap:ak8PFJetsCHSPrunedMass") );
-
-
-//Available user floats : 
-//NjettinessAK8Puppi:tau1 
-//NjettinessAK8Puppi:tau2 
-//NjettinessAK8Puppi:tau3 
-//ak8PFJetsCHSValueMap:NjettinessAK8CHSTau1 
-//ak8PFJetsCHSValueMap:NjettinessAK8CHSTau2 
-//ak8PFJetsCHSValueMap:NjettinessAK8CHSTau3 
-//ak8PFJetsCHSValueMap:ak8PFJetsCHSPrunedMass 
-//ak8PFJetsCHSValueMap:ak8PFJetsCHSSoftDropMass 
-//ak8PFJetsCHSValueMap:eta 
-//ak8PFJetsCHSValueMap:mass 
-//ak8PFJetsCHSValueMap:phi 
-//ak8PFJetsCHSValueMap:pt 
-//ak8PFJetsPuppiSoftDropMass 
-
-
-        jet_ak08_SoftDropMass->push_back(jet->userFloat("ak8PFJetsCHSValueMap:ak8PFJetsCHSSoftDropMass"));
-        jet_ak08_tau1->push_back(jet->userFloat("ak8PFJetsCHSValueMap:NjettinessAK8CHSTau1"));
-        jet_ak08_tau2->push_back(jet->userFloat("ak8PFJetsCHSValueMap:NjettinessAK8CHSTau2"));
-        jet_ak08_tau3->push_back(jet->userFloat("ak8PFJetsCHSValueMap:NjettinessAK8CHSTau3"));
-        jet_ak08_Puppi_tau1->push_back(jet->userFloat("NjettinessAK8Puppi:tau1"));
-        jet_ak08_Puppi_tau2->push_back(jet->userFloat("NjettinessAK8Puppi:tau2"));
-        jet_ak08_Puppi_tau3->push_back(jet->userFloat("NjettinessAK8Puppi:tau3"));
+        if( jet.pt() < _minPt ) continue;
+
+        for( std::vector<std::pair<std::vector<float>*, std::string> >::const_iterator itr = _userFloats.begin();
+                itr != _userFloats.end(); ++itr ) {
+            itr->first->push_back( jet.userFloat( itr->second ) );
+        }
+
+        _columns.endObject();
     }
 
 }
@@ -0,0 +1,66 @@
+#include <fnmatch.h>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+#include "UMDNTuple/UMDNTuple/interface/FloatPrecision.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+FloatPrecision::FloatPrecision() {
+
+}
+
+FloatPrecision::FloatPrecision( const edm::ParameterSet & iConfig ) {
+
+    if( !iConfig.exists( "floatPrecision" ) ) return;
+
+    std::vector<edm::ParameterSet> rules =
+        iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("floatPrecision");
+
+    for( std::vector<edm::ParameterSet>::const_iterator itr = rules.begin();
+            itr != rules.end(); ++itr ) {
+
+        Rule rule;
+        rule.patterns = itr->getUntrackedParameter<std::vector<std::string> >("branches");
+        rule.bits = itr->getUntrackedParameter<int>("mantissaBits");
+        if( rule.bits < 1 || rule.bits > 23 ) {
+            throw cms::Exception("Configuration")
+            << "mantissaBits must be between 1 and 23, got " << rule.bits;
+        }
+        _rules.push_back( rule );
+    }
+}
+
+int FloatPrecision::mantissaBits( const std::string &branch ) const {
+
+    int bits = -1;
+    for( std::vector<Rule>::const_iterator itr = _rules.begin();
+            itr != _rules.end(); ++itr ) {
+        for( std::vector<std::string>::const_iterator pitr = itr->patterns.begin();
+                pitr != itr->patterns.end(); ++pitr ) {
+            if( fnmatch( pitr->c_str(), branch.c_str(), 0 ) == 0 ) {
+                bits = itr->bits;
+                break;
+            }
+        }
+    }
+    // 23 bits is the full float mantissa
+    if( bits == 23 ) return -1;
+    return bits;
+}
+
+void FloatPrecision::truncate( float *values, size_t n, int bits ) {
+
+    if( bits < 0 ) return;
+
+    const int shift = 23 - bits;
+    const uint32_t mask = ~0u << shift;
+    const uint32_t half = 1u << ( shift - 1 );
+
+    for( size_t i = 0; i < n; ++i ) {
+        if( !std::isfinite( values[i] ) ) continue;
+        uint32_t word;
+        std::memcpy( &word, &values[i], sizeof( word ) );
+        word = ( word + half ) & mask;
+        std::memcpy( &values[i], &word, sizeof( word ) );
+    }
+}
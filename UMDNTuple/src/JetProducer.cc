@@ -3,31 +3,8 @@
 #include "FWCore/Framework/interface/Event.h"
 
 JetProducer::JetProducer(  ) : 
-    jet_n(0),
-    jet_pt(0),
-    jet_eta(0),
-    jet_phi(0),
-    jet_e(0),
-    jet_nhf(0),
-    jet_chf(0),
-    jet_muf(0),
-    jet_cemf(0),
-    jet_nemf(0),
-    jet_cmult(0),
-    jet_nmult(0),
-    jet_ndaughters(0),
-    jet_bTagCSV(0),
-    jet_bTagCSVV1(0),
-    jet_bTagCSVSLV1(0),
-    jet_bTagCisvV2(0),
-    jet_bTagJp(0),
-    jet_bTagBjp(0),
-    jet_bTagTche(0),
-    jet_bTagTchp(0),
-    jet_bTagSsvhe(0),
-    jet_bTagSsvhp(0),
-    jet_HFHadE(0),
-    jet_HFEmE(0),
+    // missing discriminators give -1000 like bDiscriminator
+    _bTagIndex( false, -1000. ),
     _detail(99)
 {
 
@@ -35,7 +12,8 @@ JetProducer::JetProducer(  ) :
 
 void JetProducer::initialize( const std::string &prefix,
                                     const edm::EDGetTokenT<edm::View<pat::Jet> >&jetTok,
-                                    TTree *tree, float minPt, int detail) {
+                                    TTree *tree, float minPt, int detail,
+                                    const BranchSelection &selection ) {
 
     _prefix = prefix;
     _jetToken = jetTok;
@@ -43,133 +21,112 @@ void JetProducer::initialize( const std::string &prefix,
     _minPt = minPt;
 	std::cout<<"jetproducer::initialize "<<_minPt<<" "<<minPt<<std::endl;
 
-    tree->Branch( (prefix + "_n" ).c_str(), &jet_n, (prefix + "_n/I" ).c_str() );
-
-    tree->Branch( (prefix + "_pt" ).c_str(), &jet_pt );
-    tree->Branch( (prefix + "_eta").c_str(), &jet_eta );
-    tree->Branch( (prefix + "_phi").c_str(), &jet_phi );
-    tree->Branch( (prefix + "_e"  ).c_str(), &jet_e );
-
-    if( _detail > 0 ) {
-
-        tree->Branch( (prefix + "_nhf" ).c_str()         , &jet_nhf);
-        tree->Branch( (prefix + "_chf" ).c_str()         , &jet_chf);
-        tree->Branch( (prefix + "_muf" ).c_str()         , &jet_muf);
-        tree->Branch( (prefix + "_cemf" ).c_str()        , &jet_cemf);
-        tree->Branch( (prefix + "_nemf" ).c_str()        , &jet_nemf);
-        tree->Branch( (prefix + "_cmult" ).c_str()       , &jet_cmult);
-        tree->Branch( (prefix + "_nmult" ).c_str()       , &jet_nmult);
-        tree->Branch( (prefix + "_ndaughters" ).c_str()  , &jet_ndaughters);
-        tree->Branch( (prefix + "_bTagCisvV2" ).c_str()  , &jet_bTagCisvV2);
-
-        if( _detail > 1 ) {
-
-            tree->Branch( (prefix + "_bTagCSV" ).c_str()     , &jet_bTagCSV);
-            tree->Branch( (prefix + "_bTagCSVV1" ).c_str()   , &jet_bTagCSVV1);
-            tree->Branch( (prefix + "_bTagCSVSLV1" ).c_str() , &jet_bTagCSVSLV1);
+    _columns.initialize( prefix, tree, detail, selection );
+
+    jet_pt  = _columns.add<float>( "pt" );
+    jet_eta = _columns.add<float>( "eta" );
+    jet_phi = _columns.add<float>( "phi" );
+    jet_e   = _columns.add<float>( "e" );
+
+    // the PF fractions are -1 for jets without PF information
+    jet_nhf        = _columns.add<float>( "nhf"       , 1, -1 );
+    jet_chf        = _columns.add<float>( "chf"       , 1, -1 );
+    jet_muf        = _columns.add<float>( "muf"       , 1, -1 );
+    jet_cemf       = _columns.add<float>( "cemf"      , 1, -1 );
+    jet_nemf       = _columns.add<float>( "nemf"      , 1, -1 );
+    jet_cmult      = _columns.add<int>  ( "cmult"     , 1, -1 );
+    jet_nmult      = _columns.add<int>  ( "nmult"     , 1, -1 );
+    jet_ndaughters = _columns.add<int>  ( "ndaughters", 1 );
+    jet_bTagCisvV2 = _columns.add<float>( "bTagCisvV2", 1 );
+
+    jet_bTagCSV     = _columns.add<float>( "bTagCSV"    , 2 );
+    jet_bTagCSVV1   = _columns.add<float>( "bTagCSVV1"  , 2 );
+    jet_bTagCSVSLV1 = _columns.add<float>( "bTagCSVSLV1", 2 );
+
+    jet_bTagJp    = _columns.add<float>( "bTagJp"   , 2 );
+    jet_bTagBjp   = _columns.add<float>( "bTagBjp"  , 2 );
+    jet_bTagTche  = _columns.add<float>( "bTagTche" , 2 );
+    jet_bTagTchp  = _columns.add<float>( "bTagTchp" , 2 );
+    jet_bTagSsvhe = _columns.add<float>( "bTagSsvhe", 2 );
+    jet_bTagSsvhp = _columns.add<float>( "bTagSsvhp", 2 );
+    jet_HFHadE    = _columns.add<float>( "HFHadE"   , 2, -1 );
+    jet_HFEmE     = _columns.add<float>( "HFEmE"    , 2, -1 );
+
+    _bTags.clear();
+    _bTagIndex.clear();
+    addBTag( jet_bTagCisvV2 , "pfCombinedInclusiveSecondaryVertexV2BJetTags" );
+    addBTag( jet_bTagCSV    , "combinedSecondaryVertexBJetTags" );
+    addBTag( jet_bTagCSVV1  , "combinedSecondaryVertexV1BJetTags" );
+    addBTag( jet_bTagCSVSLV1, "combinedSecondaryVertexSoftPFLeptonV1BJetTags" );
+    addBTag( jet_bTagJp     , "pfJetProbabilityBJetTags" );
+    addBTag( jet_bTagBjp    , "pfJetBProbabilityBJetTags" );
+    addBTag( jet_bTagTche   , "pfTrackCountingHighEffBJetTags" );
+    addBTag( jet_bTagTchp   , "pfTrackCountingHighPurBJetTags" );
+    addBTag( jet_bTagSsvhe  , "pfSimpleSecondaryVertexHighEffBJetTags" );
+    addBTag( jet_bTagSsvhp  , "pfSimpleSecondaryVertexHighPurBJetTags" );
+}
 
+void JetProducer::addBTag( std::vector<float> *column, const std::string &discriminator ) {
 
-            tree->Branch( (prefix + "_bTagJp" ).c_str()      , &jet_bTagJp);
-            tree->Branch( (prefix + "_bTagBjp" ).c_str()     , &jet_bTagBjp);
-            tree->Branch( (prefix + "_bTagTche" ).c_str()    , &jet_bTagTche);
-            tree->Branch( (prefix + "_bTagTchp" ).c_str()    , &jet_bTagTchp);
-            tree->Branch( (prefix + "_bTagSsvhe" ).c_str()   , &jet_bTagSsvhe);
-            tree->Branch( (prefix + "_bTagSsvhp" ).c_str()   , &jet_bTagSsvhp);
-            tree->Branch( (prefix + "_HFHadE" ).c_str()      , &jet_HFHadE);
-            tree->Branch( (prefix + "_HFEmE" ).c_str()       , &jet_HFEmE);
-        }
+    // dropped columns are not looked up
+    if( _columns.booked( column ) ) {
+        _bTags.push_back( std::make_pair( column, _bTagIndex.add( discriminator ) ) );
     }
 }
 
 
-void JetProducer::produce(const edm::Event &iEvent ) {
-
-    jet_n = 0;
-    jet_pt->clear();
-    jet_eta->clear();
-    jet_phi->clear();
-    jet_e->clear();
-    if( _detail > 0 ) {
-        jet_nhf->clear();
-        jet_chf->clear();
-        jet_muf->clear();
-        jet_cemf->clear();
-        jet_nemf->clear();
-        jet_cmult->clear();
-        jet_nmult->clear();
-        jet_ndaughters->clear();
-        jet_bTagCisvV2->clear();
-        if( _detail > 1) {
-            jet_bTagCSV->clear();
-            jet_bTagCSVV1->clear();
-            jet_bTagCSVSLV1->clear();
-            jet_bTagJp->clear();
-            jet_bTagBjp->clear();
-            jet_bTagTche->clear();
-            jet_bTagTchp->clear();
-            jet_bTagSsvhe->clear();
-            jet_bTagSsvhp->clear();
-            jet_HFHadE->clear();
-            jet_HFEmE->clear();
-        }
-            
-    }
+void JetProducer::produce(const edm::Event &iEvent, const EventContext & ) {
+
+    _columns.clear();
 
     iEvent.getByToken(_jetToken,jets);
+    _columns.reserve( jets->size() );
+    _bTagIndex.reset();
 
     for (unsigned int j=0; j < jets->size();++j){
-        edm::Ptr<pat::Jet> jet = jets->ptrAt(j);
+        const pat::Jet & jet = jets->at(j);
  
-        if( jet->pt() < _minPt ) continue;
-
-        jet_n += 1;
+        if( jet.pt() < _minPt ) continue;
 
-        jet_pt -> push_back( jet->pt() );
-        jet_eta -> push_back( jet->eta() );
-        jet_phi -> push_back( jet->phi() );
-        jet_e -> push_back( jet->energy() );
+        jet_pt -> push_back( jet.pt() );
+        jet_eta -> push_back( jet.eta() );
+        jet_phi -> push_back( jet.phi() );
+        jet_e -> push_back( jet.energy() );
 
         if( _detail > 0 ) {
 
-            jet_ndaughters -> push_back( jet->numberOfDaughters());
-
-            if( jet->hasPFSpecific()) {
-            jet_nhf        -> push_back( jet->neutralHadronEnergyFraction());
-            jet_chf        -> push_back( jet->chargedHadronEnergyFraction());
-            jet_cemf       -> push_back( jet->chargedEmEnergyFraction());
-            jet_nemf       -> push_back( jet->neutralEmEnergyFraction());
-            jet_muf        -> push_back( jet->muonEnergyFraction());
-            jet_cmult      -> push_back( jet->chargedMultiplicity());
-            jet_nmult      -> push_back( jet->neutralMultiplicity());
-	    }else {
-	     	jet_chf-> push_back(-1.0);
+            jet_ndaughters -> push_back( jet.numberOfDaughters());
+
+            if( jet.hasPFSpecific()) {
+            jet_nhf        -> push_back( jet.neutralHadronEnergyFraction());
+            jet_chf        -> push_back( jet.chargedHadronEnergyFraction());
+            jet_cemf       -> push_back( jet.chargedEmEnergyFraction());
+            jet_nemf       -> push_back( jet.neutralEmEnergyFraction());
+            jet_muf        -> push_back( jet.muonEnergyFraction());
+            jet_cmult      -> push_back( jet.chargedMultiplicity());
+            jet_nmult      -> push_back( jet.neutralMultiplicity());
 	    }
-            jet_bTagCisvV2  ->push_back(jet->bDiscriminator("pfCombinedInclusiveSecondaryVertexV2BJetTags"));
 
             if( _detail > 1 ) {
 
-
-                jet_bTagCSV     ->push_back(jet->bDiscriminator("combinedSecondaryVertexBJetTags"));
-                jet_bTagCSVV1   ->push_back(jet->bDiscriminator("combinedSecondaryVertexV1BJetTags"));
-                jet_bTagCSVSLV1 ->push_back(jet->bDiscriminator("combinedSecondaryVertexSoftPFLeptonV1BJetTags"));
-
-                jet_bTagJp      ->push_back(jet->bDiscriminator("pfJetProbabilityBJetTags"));
-                jet_bTagBjp     ->push_back(jet->bDiscriminator("pfJetBProbabilityBJetTags"));
-                jet_bTagTche    ->push_back(jet->bDiscriminator("pfTrackCountingHighEffBJetTags"));
-                jet_bTagTchp    ->push_back(jet->bDiscriminator("pfTrackCountingHighPurBJetTags"));
-                jet_bTagSsvhe   ->push_back(jet->bDiscriminator("pfSimpleSecondaryVertexHighEffBJetTags"));
-                jet_bTagSsvhp   ->push_back(jet->bDiscriminator("pfSimpleSecondaryVertexHighPurBJetTags"));
-
                 // this would be for gen jets
                 //JetAk04PartFlav_->push_back(jet.partonFlavour());
                 //JetAk04HadFlav_->push_back(jet.hadronFlavour());
 
-            	if( jet->hasPFSpecific()) {
-                  jet_HFHadE->push_back(jet->HFHadronEnergy());
-                  jet_HFEmE->push_back(jet->HFEMEnergy());
+            	if( jet.hasPFSpecific()) {
+                  jet_HFHadE->push_back(jet.HFHadronEnergy());
+                  jet_HFEmE->push_back(jet.HFEMEnergy());
 		}
             }
         }
+
+        const std::vector<std::pair<std::string, float> > & discriminators = jet.getPairDiscri();
+        for( std::vector<std::pair<std::vector<float>*, unsigned> >::const_iterator itr = _bTags.begin();
+                itr != _bTags.end(); ++itr ) {
+            itr->first->push_back( _bTagIndex.value( discriminators, itr->second ) );
+        }
+
+        _columns.endObject();
     }
 
 }
@@ -0,0 +1,33 @@
+#include "UMDNTuple/UMDNTuple/interface/KeyIndexCache.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+KeyIndexCache::KeyIndexCache( bool required, float missing ) :
+    _size(-1),
+    _required( required ),
+    _missing( missing )
+{
+}
+
+unsigned KeyIndexCache::add( const std::string &key ) {
+
+    _keys.push_back( key );
+    _index.push_back( -1 );
+    _size = -1;
+    return _keys.size() - 1;
+}
+
+void KeyIndexCache::clear() {
+
+    _keys.clear();
+    _index.clear();
+    _size = -1;
+}
+
+float KeyIndexCache::missing( unsigned key ) const {
+
+    if( _required ) {
+        throw cms::Exception("Configuration")
+        << "Key " << _keys[key] << " not found";
+    }
+    return _missing;
+}
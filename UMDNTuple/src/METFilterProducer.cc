@@ -1,11 +1,14 @@
 #include <bitset>
 #include <sstream>
+#include <algorithm>
 #include <iostream>
 #include "UMDNTuple/UMDNTuple/interface/METFilterProducer.h"
 #include "FWCore/Framework/interface/Event.h"
 
 METFilterProducer::METFilterProducer(  ) :
-    _passing_filters(0)
+    _filter_idx_map(0),
+    _passing_filters(0),
+    _bitmask(false)
 {
 
 }
@@ -13,15 +16,20 @@ METFilterProducer::METFilterProducer(  ) :
 void METFilterProducer::initialize( const std::string &prefix,
             const edm::EDGetTokenT<edm::TriggerResults>& trigTok,
             const std::vector<std::string> &filtMap,
-            TTree *tree, TTree *infotree) {
+            TTree *tree, TTree *infotree, bool bitmask) {
 
     _prefix = prefix;
     _filterToken = trigTok;
     _infoTree = infotree;
+    _bitmask = bitmask;
 
-    tree->Branch("passedFilters", &_passing_filters );
+    _passing_filters = &_passing_filter_ids;
+    if( !_bitmask ) {
+        tree->Branch("passedFilters", &_passing_filters );
+    }
 
-    _filter_idx_map.clear();
+    _filter_idx_cache.clear();
+    _filter_idx_map = 0;
     _filter_map.clear();
 
     for( std::vector<std::string>::const_iterator itr = filtMap.begin();
@@ -41,6 +49,20 @@ void METFilterProducer::initialize( const std::string &prefix,
 
     }
 
+    if( _bitmask ) {
+        // enough 64 bit words for the largest filter id
+        int max_idx = 0;
+        for( std::map<std::string, int>::const_iterator itr = _filter_map.begin();
+                itr != _filter_map.end(); ++itr ) {
+            max_idx = std::max( max_idx, itr->second );
+        }
+        _filterBits.assign( max_idx/64 + 1, 0 );
+
+        std::stringstream leaflist;
+        leaflist << "passedFilterBits[" << _filterBits.size() << "]/l";
+        tree->Branch("passedFilterBits", &_filterBits[0], leaflist.str().c_str() );
+    }
+
 }
 
 void METFilterProducer::addBadChargedCandidateFilterToken( const edm::EDGetTokenT<bool> & tok)  { 
@@ -50,7 +72,7 @@ void METFilterProducer::addBadPFMuonFilterToken( const edm::EDGetTokenT<bool> &
     _BadPFMuonFilterToken = tok;
 }
 
-void METFilterProducer::produce(const edm::Event &iEvent ) {
+void METFilterProducer::produce(const edm::Event &iEvent, const EventContext & ) {
 
     edm::Handle<edm::TriggerResults> filters;
     iEvent.getByToken(_filterToken,filters);
@@ -64,22 +86,38 @@ void METFilterProducer::produce(const edm::Event &iEvent ) {
 
     const edm::TriggerNames filtNames( iEvent.triggerNames( *filters ) );
 
-    if( _filter_idx_map.size() == 0 ) {
+    // rebuild the index map when the filter menu changes,
+    // keeping one per menu
+    const edm::ParameterSetID & menu = filtNames.parameterSetID();
+
+    if( !_filter_idx_map || menu != _filter_menu ) {
+
+        std::map<edm::ParameterSetID, std::vector<std::pair<int, int> > >::iterator citr =
+            _filter_idx_cache.find( menu );
 
-        for (unsigned i = 0; i < filtNames.size(); i++) {
+        if( citr == _filter_idx_cache.end() ) {
 
-            std::string filtname = filtNames.triggerName(i);
+            std::vector<std::pair<int, int> > & idx_map = _filter_idx_cache[menu];
 
-            std::map<std::string, int>::const_iterator mitr = _filter_map.find(filtname);
+            for (unsigned i = 0; i < filtNames.size(); i++) {
 
-            if( mitr != _filter_map.end() ) {
-                _filter_idx_map.push_back( std::make_pair(i, mitr->second) );
+                std::string filtname = filtNames.triggerName(i);
+
+                std::map<std::string, int>::const_iterator mitr = _filter_map.find(filtname);
+
+                if( mitr != _filter_map.end() ) {
+                    idx_map.push_back( std::make_pair(i, mitr->second) );
+                }
             }
+            citr = _filter_idx_cache.find( menu );
         }
+
+        _filter_idx_map = &citr->second;
+        _filter_menu = menu;
     }
 
-    for( std::vector<std::pair<int,int> >::const_iterator mitr = _filter_idx_map.begin();
-            mitr != _filter_idx_map.end(); ++mitr ) {
+    for( std::vector<std::pair<int,int> >::const_iterator mitr = _filter_idx_map->begin();
+            mitr != _filter_idx_map->end(); ++mitr ) {
         if( filters->accept( mitr->first ) ) {
             _passing_filters->push_back( mitr->second );
         }
@@ -101,6 +139,15 @@ void METFilterProducer::produce(const edm::Event &iEvent ) {
         }
     }
 
+    if( _bitmask ) {
+        std::fill( _filterBits.begin(), _filterBits.end(), 0 );
+        for( std::vector<int>::const_iterator itr = _passing_filters->begin();
+                itr != _passing_filters->end(); ++itr ) {
+            if( *itr < 0 ) continue;
+            _filterBits[*itr/64] |= ( ULong64_t(1) << ( *itr % 64 ) );
+        }
+    }
+
 }
 
 void METFilterProducer::endRun() {
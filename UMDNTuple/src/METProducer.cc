@@ -88,12 +88,13 @@ void METProducer::initialize( const std::string &prefix,
 }
 
 
-void METProducer::produce(const edm::Event &iEvent ) {
+void METProducer::produce(const edm::Event &iEvent, const EventContext & ) {
 
     iEvent.getByToken(_metToken,mets);
+    const pat::MET & met = mets->front();
 
-    met_pt = mets->ptrAt(0)->pt();
-    met_phi = mets->ptrAt(0)->phi();
+    met_pt = met.pt();
+    met_phi = met.phi();
     allmet_pt->clear();
     allmet_phi->clear();
    
@@ -103,43 +104,43 @@ void METProducer::produce(const edm::Event &iEvent ) {
 	pat::MET::METCorrectionLevel ii = static_cast<pat::MET::METCorrectionLevel> (i);
 	//std::cout<<i<< " "<<mets->ptrAt(0)->corPt (ii)<< " "
 	//       	 	  <<mets->ptrAt(0)->corPhi(ii)<<std::endl;
-    	allmet_pt->push_back(	       mets->ptrAt(0)->corPt (ii));
-    	allmet_phi->push_back(	       mets->ptrAt(0)->corPhi (ii));
+    	allmet_pt->push_back(	       met.corPt (ii));
+    	allmet_phi->push_back(	       met.corPhi (ii));
     }
 
-    met_Type1XY_pt            = mets->ptrAt(0)->corPt (pat::MET::Type1XY           );
-    met_Type1XY_phi           = mets->ptrAt(0)->corPhi(pat::MET::Type1XY           );
-    met_Type1Smear_pt         = mets->ptrAt(0)->corPt (pat::MET::Type1Smear           );
-    met_Type1Smear_phi        = mets->ptrAt(0)->corPhi(pat::MET::Type1Smear           );
-    met_Type1SmearXY_pt       = mets->ptrAt(0)->corPt (pat::MET::Type1SmearXY           );
-    met_Type1SmearXY_phi      = mets->ptrAt(0)->corPhi(pat::MET::Type1SmearXY           );
-
-
-
-    met_JetResUp_pt           = mets->ptrAt(0)->shiftedPt(pat::MET::JetResUp           );
-    met_JetResUp_phi          = mets->ptrAt(0)->shiftedPhi(pat::MET::JetResUp          );
-    met_JetResDown_pt         = mets->ptrAt(0)->shiftedPt(pat::MET::JetResDown         );
-    met_JetResDown_phi        = mets->ptrAt(0)->shiftedPhi(pat::MET::JetResDown        );
-    met_JetEnUp_pt            = mets->ptrAt(0)->shiftedPt(pat::MET::JetEnUp            );
-    met_JetEnUp_phi           = mets->ptrAt(0)->shiftedPhi(pat::MET::JetEnUp           );
-    met_JetEnDown_pt          = mets->ptrAt(0)->shiftedPt(pat::MET::JetEnDown          );
-    met_JetEnDown_phi         = mets->ptrAt(0)->shiftedPhi(pat::MET::JetEnDown         );
-    met_MuonEnUp_pt           = mets->ptrAt(0)->shiftedPt(pat::MET::MuonEnUp           );
-    met_MuonEnUp_phi          = mets->ptrAt(0)->shiftedPhi(pat::MET::MuonEnUp          );
-    met_MuonEnDown_pt         = mets->ptrAt(0)->shiftedPt(pat::MET::MuonEnDown         );
-    met_MuonEnDown_phi        = mets->ptrAt(0)->shiftedPhi(pat::MET::MuonEnDown        );
-    met_ElectronEnUp_pt       = mets->ptrAt(0)->shiftedPt(pat::MET::ElectronEnUp       );
-    met_ElectronEnUp_phi      = mets->ptrAt(0)->shiftedPhi(pat::MET::ElectronEnUp      );
-    met_ElectronEnDown_pt     = mets->ptrAt(0)->shiftedPt(pat::MET::ElectronEnDown     );
-    met_ElectronEnDown_phi    = mets->ptrAt(0)->shiftedPhi(pat::MET::ElectronEnDown    );
-    met_PhotonEnUp_pt         = mets->ptrAt(0)->shiftedPt(pat::MET::PhotonEnUp         );
-    met_PhotonEnUp_phi        = mets->ptrAt(0)->shiftedPhi(pat::MET::PhotonEnUp        );
-    met_PhotonEnDown_pt       = mets->ptrAt(0)->shiftedPt(pat::MET::PhotonEnDown       );
-    met_PhotonEnDown_phi      = mets->ptrAt(0)->shiftedPhi(pat::MET::PhotonEnDown      );
-    met_UnclusteredEnUp_pt    = mets->ptrAt(0)->shiftedPt(pat::MET::UnclusteredEnUp    );
-    met_UnclusteredEnUp_phi   = mets->ptrAt(0)->shiftedPhi(pat::MET::UnclusteredEnUp   );
-    met_UnclusteredEnDown_pt  = mets->ptrAt(0)->shiftedPt(pat::MET::UnclusteredEnDown  );
-    met_UnclusteredEnDown_phi = mets->ptrAt(0)->shiftedPhi(pat::MET::UnclusteredEnDown );
+    met_Type1XY_pt            = met.corPt (pat::MET::Type1XY           );
+    met_Type1XY_phi           = met.corPhi(pat::MET::Type1XY           );
+    met_Type1Smear_pt         = met.corPt (pat::MET::Type1Smear           );
+    met_Type1Smear_phi        = met.corPhi(pat::MET::Type1Smear           );
+    met_Type1SmearXY_pt       = met.corPt (pat::MET::Type1SmearXY           );
+    met_Type1SmearXY_phi      = met.corPhi(pat::MET::Type1SmearXY           );
+
+
+
+    met_JetResUp_pt           = met.shiftedPt(pat::MET::JetResUp           );
+    met_JetResUp_phi          = met.shiftedPhi(pat::MET::JetResUp          );
+    met_JetResDown_pt         = met.shiftedPt(pat::MET::JetResDown         );
+    met_JetResDown_phi        = met.shiftedPhi(pat::MET::JetResDown        );
+    met_JetEnUp_pt            = met.shiftedPt(pat::MET::JetEnUp            );
+    met_JetEnUp_phi           = met.shiftedPhi(pat::MET::JetEnUp           );
+    met_JetEnDown_pt          = met.shiftedPt(pat::MET::JetEnDown          );
+    met_JetEnDown_phi         = met.shiftedPhi(pat::MET::JetEnDown         );
+    met_MuonEnUp_pt           = met.shiftedPt(pat::MET::MuonEnUp           );
+    met_MuonEnUp_phi          = met.shiftedPhi(pat::MET::MuonEnUp          );
+    met_MuonEnDown_pt         = met.shiftedPt(pat::MET::MuonEnDown         );
+    met_MuonEnDown_phi        = met.shiftedPhi(pat::MET::MuonEnDown        );
+    met_ElectronEnUp_pt       = met.shiftedPt(pat::MET::ElectronEnUp       );
+    met_ElectronEnUp_phi      = met.shiftedPhi(pat::MET::ElectronEnUp      );
+    met_ElectronEnDown_pt     = met.shiftedPt(pat::MET::ElectronEnDown     );
+    met_ElectronEnDown_phi    = met.shiftedPhi(pat::MET::ElectronEnDown    );
+    met_PhotonEnUp_pt         = met.shiftedPt(pat::MET::PhotonEnUp         );
+    met_PhotonEnUp_phi        = met.shiftedPhi(pat::MET::PhotonEnUp        );
+    met_PhotonEnDown_pt       = met.shiftedPt(pat::MET::PhotonEnDown       );
+    met_PhotonEnDown_phi      = met.shiftedPhi(pat::MET::PhotonEnDown      );
+    met_UnclusteredEnUp_pt    = met.shiftedPt(pat::MET::UnclusteredEnUp    );
+    met_UnclusteredEnUp_phi   = met.shiftedPhi(pat::MET::UnclusteredEnUp   );
+    met_UnclusteredEnDown_pt  = met.shiftedPt(pat::MET::UnclusteredEnDown  );
+    met_UnclusteredEnDown_phi = met.shiftedPhi(pat::MET::UnclusteredEnDown );
 
 }
 
@@ -0,0 +1,165 @@
+#include "UMDNTuple/UMDNTuple/interface/NTupleWriter.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+NTupleWriter::NTupleWriter( const edm::ParameterSet & iConfig ) :
+    _outputSettings( iConfig ),
+    _floatPrecision( iConfig ),
+    _weightInfoTree(0),
+    _trigInfoTree(0),
+    _filterInfoTree(0)
+{
+    bool arrayBranches = false;
+    bool packIdBits = false;
+    if( iConfig.exists( "arrayBranches" ) ) {
+        arrayBranches = iConfig.getUntrackedParameter<bool>("arrayBranches");
+    }
+    if( iConfig.exists( "packIdBits" ) ) {
+        packIdBits = iConfig.getUntrackedParameter<bool>("packIdBits");
+    }
+
+    edm::Service<TFileService> fs;
+
+    // Create tree to store metadata
+    _weightInfoTree = fs->make<TTree>( "WeightInfoTree", "WeightInfoTree" );
+    // Create tree to store metadata
+    _trigInfoTree = fs->make<TTree>( "TrigInfoTree", "TrigInfoTree" );
+    _filterInfoTree = fs->make<TTree>( "FilterInfoTree", "FilterInfoTree" );
+
+    std::string fileName;
+    Long64_t maxEvents = 0;
+    Long64_t maxBytes = 0;
+    if( iConfig.exists( "rollover" ) ) {
+        edm::ParameterSet rollover = iConfig.getUntrackedParameter<edm::ParameterSet>("rollover");
+        fileName = rollover.getUntrackedParameter<std::string>("fileName");
+        if( rollover.exists( "maxEvents" ) ) {
+            maxEvents = rollover.getUntrackedParameter<long long>("maxEvents");
+        }
+        if( rollover.exists( "maxMB" ) ) {
+            maxBytes = rollover.getUntrackedParameter<double>("maxMB")*1024*1024;
+        }
+        if( maxEvents <= 0 && maxBytes <= 0 ) {
+            throw cms::Exception("Configuration")
+            << "The rollover needs maxEvents or maxMB";
+        }
+    }
+
+    std::string asyncFileName;
+    int flushEvents = 1000;
+    if( iConfig.exists( "asyncOutput" ) ) {
+        edm::ParameterSet async = iConfig.getUntrackedParameter<edm::ParameterSet>("asyncOutput");
+        asyncFileName = async.getUntrackedParameter<std::string>("fileName");
+        if( async.exists( "flushEvents" ) ) {
+            flushEvents = async.getUntrackedParameter<int>("flushEvents");
+        }
+        if( !fileName.empty() ) {
+            throw cms::Exception("Configuration")
+            << "asyncOutput can not be combined with rollover";
+        }
+    }
+
+    if( !iConfig.exists( "outputs" ) ) {
+        _outputConfigs.push_back( iConfig );
+        _outputs.push_back( new OutputTree( iConfig, *fs, arrayBranches, packIdBits,
+                                            &_outputSettings, &_floatPrecision ) );
+        if( !fileName.empty() ) _outputs.back()->setRollover( fileName, maxEvents, maxBytes );
+        if( !asyncFileName.empty() ) _outputs.back()->setAsync( asyncFileName + ".root", flushEvents );
+        return;
+    }
+
+    _outputConfigs = iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("outputs");
+    if( _outputConfigs.empty() ) {
+        throw cms::Exception("Configuration")
+        << "The outputs VPSet must have at least one entry";
+    }
+    if( iConfig.exists( "skim" ) ) {
+        throw cms::Exception("Configuration")
+        << "With outputs the skim is given separately for each output";
+    }
+
+    std::set<std::string> names;
+    for( std::vector<edm::ParameterSet>::const_iterator itr = _outputConfigs.begin();
+            itr != _outputConfigs.end(); ++itr ) {
+
+        std::string name = itr->getUntrackedParameter<std::string>("name");
+        if( !names.insert( name ).second ) {
+            throw cms::Exception("Configuration")
+            << "Output " << name << " is defined twice";
+        }
+        _outputs.push_back( new OutputTree( *itr, fs->mkdir( name ), arrayBranches, packIdBits,
+                                            &_outputSettings, &_floatPrecision ) );
+        if( !fileName.empty() ) _outputs.back()->setRollover( fileName + "_" + name, maxEvents, maxBytes );
+        if( !asyncFileName.empty() ) _outputs.back()->setAsync( asyncFileName + "_" + name + ".root", flushEvents );
+    }
+}
+
+NTupleWriter::~NTupleWriter() {
+
+    for( unsigned i = 0; i < _outputs.size(); ++i ) {
+        delete _outputs[i];
+    }
+}
+
+void NTupleWriter::book( TTree *streamTree ) const {
+
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    for( std::vector<OutputTree*>::const_iterator itr = _outputs.begin();
+            itr != _outputs.end(); ++itr ) {
+        (*itr)->book( streamTree );
+    }
+
+}
+
+void NTupleWriter::fill( TTree *streamTree, const std::vector<bool> &passed ) const {
+
+    bool any = false;
+    for( unsigned i = 0; i < _outputs.size(); ++i ) {
+        _outputs[i]->count( passed[i] );
+        if( passed[i] && _outputs[i]->async() ) {
+            // each stream has its own tree, no lock needed
+            _outputs[i]->fill( streamTree );
+            continue;
+        }
+        any |= passed[i];
+    }
+    if( !any ) return;
+
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    for( unsigned i = 0; i < _outputs.size(); ++i ) {
+        if( passed[i] && !_outputs[i]->async() ) _outputs[i]->fill( streamTree );
+    }
+
+}
+
+void NTupleWriter::endJob() const {
+
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    std::vector<TTree*> metadata;
+    metadata.push_back( _weightInfoTree );
+    metadata.push_back( _trigInfoTree );
+    metadata.push_back( _filterInfoTree );
+
+    for( std::vector<OutputTree*>::const_iterator itr = _outputs.begin();
+            itr != _outputs.end(); ++itr ) {
+        (*itr)->endJob( metadata );
+    }
+
+}
+
+bool NTupleWriter::claimRun( unsigned run ) const {
+
+    return _claimedRuns.insert( run ).second;
+
+}
+
+void NTupleWriter::configureInfoTrees() const {
+
+    _outputSettings.apply( _weightInfoTree );
+    _outputSettings.apply( _trigInfoTree );
+    _outputSettings.apply( _filterInfoTree );
+
+}
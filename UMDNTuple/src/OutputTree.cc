@@ -0,0 +1,623 @@
+#include <typeinfo>
+#include <cstring>
+#include <sstream>
+#include "UMDNTuple/UMDNTuple/interface/OutputTree.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "TObjArray.h"
+#include "TBranchElement.h"
+#include "TLeaf.h"
+#include "TClass.h"
+#include "TBasket.h"
+
+namespace {
+
+    // copy one vector branch into its array buffer and
+    // return the address of the buffer
+    template<class S, class T>
+    void * stage( const void *object, std::vector<T> & buffer, int n, const std::string & name ) {
+
+        const std::vector<S> & source = *static_cast<const std::vector<S>*>( object );
+        if( source.size() != static_cast<size_t>( n ) ) {
+            throw cms::Exception("LogicError")
+            << "Branch " << name << " has " << source.size()
+            << " entries but its counter is " << n;
+        }
+        buffer.assign( source.begin(), source.end() );
+        // keep a valid address for empty events
+        if( buffer.empty() ) buffer.resize( 1 );
+        return &buffer[0];
+    }
+}
+
+OutputTree::OutputTree( const edm::ParameterSet & iConfig, TFileDirectory directory,
+                        bool arrayBranches, bool packIdBits,
+                        const TreeOutputSettings *outputSettings,
+                        const FloatPrecision *floatPrecision ) :
+    _selection( iConfig ),
+    _arrayBranches( arrayBranches ),
+    _packIdBits( packIdBits ),
+    _outputSettings( outputSettings ),
+    _floatPrecision( floatPrecision ),
+    _directory(0),
+    _eventTree(0),
+    _lastStreamTree(0),
+    _idBitInfoTree(0),
+    _skimInfoTree(0),
+    _maxEvents(0),
+    _maxBytes(0),
+    _file(0),
+    _merger(0),
+    _flushEvents(0),
+    _nEvents(0),
+    _nPassed(0)
+{
+    // the EventTree is created once the first stream is booked
+    _directory = directory.getBareDirectory();
+
+    if( _packIdBits ) {
+        _idBitInfoTree = directory.make<TTree>( "IdBitInfoTree", "IdBitInfoTree" );
+    }
+    if( iConfig.exists( "skim" ) ) {
+        _skimInfoTree = directory.make<TTree>( "SkimInfoTree", "SkimInfoTree" );
+    }
+}
+
+OutputTree::OutputTree( const OutputTree &parent, TDirectory *directory ) :
+    _selection( parent._selection ),
+    _arrayBranches( parent._arrayBranches ),
+    _packIdBits( parent._packIdBits ),
+    _outputSettings( parent._outputSettings ),
+    _floatPrecision( parent._floatPrecision ),
+    _directory( directory ),
+    _eventTree(0),
+    _lastStreamTree(0),
+    // the id bit layout is the same for all streams,
+    // only the first one records it
+    _idBitInfoTree( parent._streams.empty() ? parent._idBitInfoTree : 0 ),
+    _skimInfoTree(0),
+    _maxEvents(0),
+    _maxBytes(0),
+    _file(0),
+    _merger(0),
+    _flushEvents( parent._flushEvents ),
+    _nEvents(0),
+    _nPassed(0)
+{
+}
+
+OutputTree::~OutputTree() {
+
+    for( std::map<const TTree*, OutputTree*>::iterator itr = _streams.begin();
+            itr != _streams.end(); ++itr ) {
+        delete itr->second;
+    }
+    delete _merger;
+
+    for( unsigned i = 0; i < _arrays.size(); ++i ) {
+        delete _arrays[i];
+    }
+    for( unsigned i = 0; i < _idWords.size(); ++i ) {
+        delete _idWords[i];
+    }
+}
+
+void OutputTree::setRollover( const std::string &fileName, Long64_t maxEvents, Long64_t maxBytes ) {
+
+    _fileName = fileName;
+    _maxEvents = maxEvents;
+    _maxBytes = maxBytes;
+
+    _file = openFile( 0 );
+    _directory = _file;
+
+}
+
+void OutputTree::setAsync( const std::string &fileName, int flushEvents ) {
+
+    _merger = new ROOT::Experimental::TBufferMerger( fileName.c_str() );
+    _flushEvents = flushEvents;
+    _fileNames.push_back( fileName );
+
+}
+
+TFile * OutputTree::openFile( unsigned index ) const {
+
+    std::stringstream name;
+    name << _fileName << "_" << index << ".root";
+
+    TFile *file = TFile::Open( name.str().c_str(), "RECREATE" );
+    if( !file || file->IsZombie() ) {
+        throw cms::Exception("FileOpenError")
+        << "Could not open output file " << name.str();
+    }
+    return file;
+}
+
+void OutputTree::nextFile() {
+
+    // the baskets of the current file are written with
+    // the tree header, the tree then continues empty
+    TDirectory::TContext context( _file );
+    _eventTree->Write( "", TObject::kOverwrite );
+    _fileNames.push_back( _file->GetName() );
+
+    TFile *file = openFile( _fileNames.size() );
+    _eventTree->Reset();
+    _eventTree->SetDirectory( file );
+
+    _file->Close();
+    delete _file;
+    _file = file;
+    _directory = file;
+
+}
+
+// bytes filled into the baskets that are not written yet,
+// uncompressed, so the estimate errs on the large side
+static Long64_t bufferedBytes( TObjArray *branches ) {
+
+    Long64_t bytes = 0;
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+        TBranch *branch = static_cast<TBranch*>( branches->UncheckedAt(i) );
+        TBasket *basket = branch->GetBasket( branch->GetWriteBasket() );
+        if( basket ) bytes += basket->GetLast() - basket->GetKeylen();
+        bytes += bufferedBytes( branch->GetListOfBranches() );
+    }
+    return bytes;
+}
+
+Long64_t OutputTree::fileBytes() const {
+
+    // GetEND of the file misses the baskets still in memory,
+    // up to one cluster per branch
+    return _eventTree->GetZipBytes() + bufferedBytes( _eventTree->GetListOfBranches() );
+}
+
+void OutputTree::book( TTree *streamTree ) {
+
+    if( _merger ) {
+        if( _streams.count( streamTree ) ) return;
+        std::shared_ptr<ROOT::Experimental::TBufferMergerFile> file = _merger->GetFile();
+        OutputTree *stream = new OutputTree( *this, file.get() );
+        stream->_mergerFile = file;
+        stream->book( streamTree );
+        _streams[streamTree] = stream;
+        return;
+    }
+
+    if( _eventTree ) return;
+
+    TDirectory::TContext context( _directory );
+
+    // dropped branches, packed flags and array branches
+    // are not cloned, the last two are booked below
+    TObjArray *branches = streamTree->GetListOfBranches();
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+        TBranch *branch = static_cast<TBranch*>( branches->UncheckedAt(i) );
+        if( !_selection.selected( branch->GetName() ) ) branch->SetBit( TBranch::kDoNotProcess );
+    }
+
+    if( _packIdBits ) bookIdWords( streamTree );
+    if( _arrayBranches ) bookArrays( streamTree );
+
+    _eventTree = streamTree->CloneTree( 0 );
+    _eventTree->SetDirectory( _directory );
+
+    // the stream tree is shared by all outputs
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+        static_cast<TBranch*>( branches->UncheckedAt(i) )->ResetBit( TBranch::kDoNotProcess );
+    }
+
+    for( std::vector<IdWord*>::iterator itr = _idWords.begin();
+            itr != _idWords.end(); ++itr ) {
+
+        IdWord *word = *itr;
+        if( _arrayBranches ) {
+            word->words.resize( 1 );
+            std::string leaflist = word->name + "[" + word->counter + "]/i";
+            word->target = _eventTree->Branch( word->name.c_str(), &word->words[0], leaflist.c_str() );
+        }
+        else {
+            word->target = _eventTree->Branch( word->name.c_str(), &word->wordsPtr );
+        }
+    }
+
+    for( std::vector<ArrayColumn*>::iterator itr = _arrays.begin();
+            itr != _arrays.end(); ++itr ) {
+
+        ArrayColumn *col = *itr;
+
+        void *address = 0;
+        std::string leaflist = col->name + "[" + col->counter + "]";
+        switch( col->type ) {
+            case kFloat  : col->floats .resize( 1 ); address = &col->floats[0];  leaflist += "/F"; break;
+            case kDouble : col->doubles.resize( 1 ); address = &col->doubles[0]; leaflist += "/D"; break;
+            case kInt    : col->ints   .resize( 1 ); address = &col->ints[0];    leaflist += "/I"; break;
+            case kUInt   : col->uints  .resize( 1 ); address = &col->uints[0];   leaflist += "/i"; break;
+            case kULong64: col->ulongs .resize( 1 ); address = &col->ulongs[0];  leaflist += "/l"; break;
+            case kBool   : col->bools  .resize( 1 ); address = &col->bools[0];   leaflist += "/O"; break;
+        }
+        col->target = _eventTree->Branch( col->name.c_str(), address, leaflist.c_str() );
+    }
+
+    _outputSettings->apply( _eventTree );
+
+}
+
+void OutputTree::checkCounter( TTree *streamTree, const std::string &name,
+                               const std::string &counter ) const {
+
+    if( streamTree->GetBranch( counter.c_str() )->TestBit( TBranch::kDoNotProcess ) ) {
+        throw cms::Exception("Configuration")
+        << "Branch " << name << " is kept but its counter " << counter << " is dropped";
+    }
+}
+
+std::string OutputTree::findCounter( TTree *tree, const std::string &name ) {
+
+    // the counter is <prefix>_n, using the longest prefix
+    // of the branch name that has one
+    for( std::string::size_type pos = name.rfind( '_' );
+            pos != std::string::npos && pos > 0; pos = name.rfind( '_', pos - 1 ) ) {
+        std::string candidate = name.substr( 0, pos ) + "_n";
+        TBranch *branch = tree->GetBranch( candidate.c_str() );
+        if( branch && !dynamic_cast<TBranchElement*>( branch ) ) {
+            return candidate;
+        }
+    }
+    return "";
+}
+
+void OutputTree::bookIdWords( TTree *streamTree ) {
+
+    TClass *boolClass = TClass::GetClass( typeid( std::vector<bool> ) );
+
+    std::map<std::string, IdWord*> words;
+
+    TObjArray *branches = streamTree->GetListOfBranches();
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+
+        TBranchElement *element = dynamic_cast<TBranchElement*>( branches->UncheckedAt(i) );
+        if( !element ) continue;
+        if( TClass::GetClass( element->GetClassName() ) != boolClass ) continue;
+        if( element->TestBit( TBranch::kDoNotProcess ) ) continue;
+
+        std::string counter = findCounter( streamTree, element->GetName() );
+        if( counter.empty() ) continue;
+        checkCounter( streamTree, element->GetName(), counter );
+
+        IdWord *& word = words[counter];
+        if( !word ) {
+            word = new IdWord();
+            word->name = counter.substr( 0, counter.size() - 2 ) + "_idWord";
+            word->counter = counter;
+            word->target = 0;
+            word->wordsPtr = &word->words;
+            _idWords.push_back( word );
+        }
+        if( word->flags.size() == 32 ) {
+            throw cms::Exception("Configuration")
+            << "More than 32 flags to pack into " << word->name;
+        }
+        word->flags.push_back( element->GetName() );
+
+        element->SetBit( TBranch::kDoNotProcess );
+    }
+
+    // record the bit layout
+    if( !_idBitInfoTree ) return;
+
+    char object[1024];
+    char flag[1024];
+    int bit = 0;
+    _idBitInfoTree->Branch( "object", object, "object/C" );
+    _idBitInfoTree->Branch( "bit", &bit, "bit/I" );
+    _idBitInfoTree->Branch( "flag", flag, "flag/C" );
+
+    for( std::vector<IdWord*>::const_iterator itr = _idWords.begin();
+            itr != _idWords.end(); ++itr ) {
+        for( unsigned i = 0; i < (*itr)->flags.size(); ++i ) {
+            strncpy( object, (*itr)->name.c_str(), sizeof( object ) - 1 );
+            object[sizeof( object ) - 1] = 0;
+            strncpy( flag, (*itr)->flags[i].c_str(), sizeof( flag ) - 1 );
+            flag[sizeof( flag ) - 1] = 0;
+            bit = i;
+            _idBitInfoTree->Fill();
+        }
+    }
+    _idBitInfoTree->ResetBranchAddresses();
+}
+
+void OutputTree::bookArrays( TTree *streamTree ) {
+
+    TClass *floatClass  = TClass::GetClass( typeid( std::vector<float> ) );
+    TClass *doubleClass = TClass::GetClass( typeid( std::vector<double> ) );
+    TClass *intClass    = TClass::GetClass( typeid( std::vector<int> ) );
+    TClass *uintClass   = TClass::GetClass( typeid( std::vector<unsigned> ) );
+    TClass *ulongClass  = TClass::GetClass( typeid( std::vector<ULong64_t> ) );
+    TClass *boolClass   = TClass::GetClass( typeid( std::vector<bool> ) );
+
+    TObjArray *branches = streamTree->GetListOfBranches();
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+
+        TBranchElement *element = dynamic_cast<TBranchElement*>( branches->UncheckedAt(i) );
+        if( !element ) continue;
+        // dropped or already packed into an id word
+        if( element->TestBit( TBranch::kDoNotProcess ) ) continue;
+
+        ArrayType type;
+        TClass *cl = TClass::GetClass( element->GetClassName() );
+        if(      cl == floatClass  ) type = kFloat;
+        else if( cl == doubleClass ) type = kDouble;
+        else if( cl == intClass    ) type = kInt;
+        else if( cl == uintClass   ) type = kUInt;
+        else if( cl == ulongClass  ) type = kULong64;
+        else if( cl == boolClass   ) type = kBool;
+        else continue;
+
+        std::string name = element->GetName();
+        std::string counter = findCounter( streamTree, name );
+        // vectors without a counter stay STL branches
+        if( counter.empty() ) continue;
+        checkCounter( streamTree, name, counter );
+
+        ArrayColumn *col = new ArrayColumn();
+        col->name = name;
+        col->counter = counter;
+        col->type = type;
+        col->target = 0;
+        _arrays.push_back( col );
+
+        element->SetBit( TBranch::kDoNotProcess );
+    }
+}
+
+void OutputTree::copyArray( const BranchBinding & binding ) {
+
+    ArrayColumn *col = binding.array;
+
+    int n = *reinterpret_cast<int*>( binding.counter->GetAddress() );
+    const void *object = static_cast<TBranchElement*>( binding.source )->GetObject();
+
+    void *address = 0;
+    switch( col->type ) {
+        case kFloat  : address = stage<float>   ( object, col->floats , n, col->name );
+                       FloatPrecision::truncate( &col->floats[0], n, binding.mantissaBits ); break;
+        case kDouble : address = stage<double>  ( object, col->doubles, n, col->name ); break;
+        case kInt    : address = stage<int>     ( object, col->ints   , n, col->name ); break;
+        case kUInt   : address = stage<unsigned>( object, col->uints  , n, col->name ); break;
+        case kULong64: address = stage<ULong64_t>( object, col->ulongs, n, col->name ); break;
+        case kBool   : address = stage<bool>    ( object, col->bools  , n, col->name ); break;
+    }
+
+    // the buffer only moves when it grows
+    if( address != binding.target->GetAddress() ) {
+        binding.target->SetAddress( address );
+    }
+}
+
+void OutputTree::packIdWords( const StreamBinding & binding ) {
+
+    for( unsigned i = 0; i < _idWords.size(); ++i ) {
+
+        IdWord *word = _idWords[i];
+        int n = *reinterpret_cast<int*>( binding.idCounters[i]->GetAddress() );
+        word->words.assign( n, 0 );
+
+        const std::vector<TBranchElement*> & flags = binding.idFlags[i];
+        for( unsigned bit = 0; bit < flags.size(); ++bit ) {
+            const std::vector<bool> & values = *static_cast<const std::vector<bool>*>( flags[bit]->GetObject() );
+            if( values.size() != static_cast<size_t>( n ) ) {
+                throw cms::Exception("LogicError")
+                << "Branch " << word->flags[bit] << " has " << values.size()
+                << " entries but its counter is " << n;
+            }
+            for( int j = 0; j < n; ++j ) {
+                if( values[j] ) word->words[j] |= ( 1u << bit );
+            }
+        }
+
+        if( _arrayBranches ) {
+            // keep a valid address for empty events
+            if( word->words.empty() ) word->words.resize( 1 );
+            if( reinterpret_cast<char*>( &word->words[0] ) != word->target->GetAddress() ) {
+                word->target->SetAddress( &word->words[0] );
+            }
+        }
+    }
+}
+
+OutputTree::StreamBinding & OutputTree::bindings( TTree *streamTree ) {
+
+    std::map<const TTree*, StreamBinding>::iterator itr = _bindings.find( streamTree );
+    if( itr != _bindings.end() ) return itr->second;
+
+    StreamBinding & binding = _bindings[streamTree];
+
+    for( std::vector<IdWord*>::const_iterator witr = _idWords.begin();
+            witr != _idWords.end(); ++witr ) {
+        binding.idCounters.push_back( streamTree->GetBranch( (*witr)->counter.c_str() ) );
+        std::vector<TBranchElement*> flags;
+        for( unsigned i = 0; i < (*witr)->flags.size(); ++i ) {
+            flags.push_back( static_cast<TBranchElement*>( streamTree->GetBranch( (*witr)->flags[i].c_str() ) ) );
+        }
+        binding.idFlags.push_back( flags );
+    }
+
+    TClass *floatClass = TClass::GetClass( typeid( std::vector<float> ) );
+
+    TObjArray *branches = _eventTree->GetListOfBranches();
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+        TBranch *target = static_cast<TBranch*>( branches->UncheckedAt(i) );
+        TBranch *source = streamTree->GetBranch( target->GetName() );
+        if( !source ) continue;
+
+        BranchBinding b;
+        b.source  = source;
+        b.target  = target;
+        b.address = 0;
+        b.array   = 0;
+        b.counter = 0;
+        for( unsigned j = 0; j < _arrays.size(); ++j ) {
+            if( _arrays[j]->target != target ) continue;
+            b.array   = _arrays[j];
+            b.counter = streamTree->GetBranch( _arrays[j]->counter.c_str() );
+        }
+
+        // float vectors, float scalars and float arrays
+        // can be stored with reduced precision
+        b.mantissaBits = -1;
+        b.floatVector = false;
+        TBranchElement *element = dynamic_cast<TBranchElement*>( target );
+        if( element ) {
+            b.floatVector = ( TClass::GetClass( element->GetClassName() ) == floatClass );
+        }
+        TLeaf *leaf = static_cast<TLeaf*>( target->GetListOfLeaves()->At(0) );
+        bool isFloat = element ? b.floatVector : ( leaf && std::string( leaf->GetTypeName() ) == "Float_t" );
+        if( isFloat ) b.mantissaBits = _floatPrecision->mantissaBits( target->GetName() );
+
+        binding.branches.push_back( b );
+    }
+
+    return binding;
+}
+
+void OutputTree::fill( TTree *streamTree ) {
+
+    if( _merger ) {
+        _streams.find( streamTree )->second->fill( streamTree );
+        return;
+    }
+
+    // point the output branches to the buffers of this stream.
+    // When the same stream fills twice in a row only the
+    // addresses that changed since the last fill are updated
+    bool sameStream = ( streamTree == _lastStreamTree );
+    _lastStreamTree = streamTree;
+
+    StreamBinding & binding = bindings( streamTree );
+    for( std::vector<BranchBinding>::iterator itr = binding.branches.begin();
+            itr != binding.branches.end(); ++itr ) {
+        if( itr->array ) {
+            copyArray( *itr );
+            continue;
+        }
+        char *address = itr->source->GetAddress();
+        if( !sameStream || address != itr->address ) {
+            itr->target->SetAddress( address );
+            itr->address = address;
+        }
+
+        // the stream buffers are cleared by the producers
+        // before the next event, so round them in place.  Later
+        // outputs of the same event see the rounded values, which
+        // is only correct because all outputs share the precision
+        // of the NTupleWriter.  The skims run before the fill
+        if( itr->mantissaBits < 0 ) continue;
+        if( itr->floatVector ) {
+            std::vector<float> *values = static_cast<std::vector<float>*>(
+                static_cast<TBranchElement*>( itr->source )->GetObject() );
+            if( values && !values->empty() ) {
+                FloatPrecision::truncate( &(*values)[0], values->size(), itr->mantissaBits );
+            }
+        }
+        else {
+            FloatPrecision::truncate( reinterpret_cast<float*>( address ), 1, itr->mantissaBits );
+        }
+    }
+
+    packIdWords( binding );
+
+    // start a new file only when there is an event for it
+    if( _file ) {
+        if( ( _maxEvents > 0 && _eventTree->GetEntries() >= _maxEvents ) ||
+            ( _maxBytes > 0 && fileBytes() >= _maxBytes ) ) {
+            nextFile();
+        }
+    }
+
+    _eventTree->Fill();
+
+    // hand the compressed baskets to the merger thread
+    if( _mergerFile && _eventTree->GetEntries() >= _flushEvents ) {
+        _mergerFile->Write();
+    }
+
+}
+
+void OutputTree::endJob( const std::vector<TTree*> &metadata ) {
+
+    if( _skimInfoTree ) {
+        ULong64_t nEvents = _nEvents;
+        ULong64_t nPassed = _nPassed;
+        _skimInfoTree->Branch( "nEvents", &nEvents, "nEvents/l" );
+        _skimInfoTree->Branch( "nPassed", &nPassed, "nPassed/l" );
+        _skimInfoTree->Fill();
+        _skimInfoTree->ResetBranchAddresses();
+    }
+
+    if( _merger ) {
+        // the merger writes the file once all buffers are merged
+        for( std::map<const TTree*, OutputTree*>::iterator itr = _streams.begin();
+                itr != _streams.end(); ++itr ) {
+            itr->second->_mergerFile->Write();
+            delete itr->second;
+        }
+        _streams.clear();
+        delete _merger;
+        _merger = 0;
+        addMetadata( metadata );
+        return;
+    }
+
+    if( !_file ) return;
+
+    {
+        TDirectory::TContext context( _file );
+        if( _eventTree ) _eventTree->Write( "", TObject::kOverwrite );
+        _fileNames.push_back( _file->GetName() );
+    }
+    _file->Close();
+    delete _file;
+    _file = 0;
+    _eventTree = 0;
+
+    addMetadata( metadata );
+
+}
+
+void OutputTree::addMetadata( const std::vector<TTree*> &metadata ) {
+
+    std::vector<TTree*> trees( metadata );
+    if( _idBitInfoTree ) trees.push_back( _idBitInfoTree );
+    if( _skimInfoTree ) trees.push_back( _skimInfoTree );
+
+    // the metadata is only complete at the end of the job,
+    // so it is added to every file once they are all closed
+    for( std::vector<TTree*>::const_iterator titr = trees.begin();
+            titr != trees.end(); ++titr ) {
+        // some info trees still point to buffers that are gone
+        (*titr)->ResetBranchAddresses();
+    }
+
+    for( std::vector<std::string>::const_iterator fitr = _fileNames.begin();
+            fitr != _fileNames.end(); ++fitr ) {
+
+        TFile *file = TFile::Open( fitr->c_str(), "UPDATE" );
+        if( !file || file->IsZombie() ) {
+            throw cms::Exception("FileOpenError")
+            << "Could not reopen output file " << *fitr;
+        }
+
+        TDirectory::TContext context( file );
+        for( std::vector<TTree*>::const_iterator titr = trees.begin();
+                titr != trees.end(); ++titr ) {
+            TTree *copy = (*titr)->CloneTree( -1 );
+            copy->SetDirectory( file );
+            copy->Write( "", TObject::kOverwrite );
+        }
+        file->Close();
+        delete file;
+    }
+
+}
@@ -1,62 +1,14 @@
 #include "UMDNTuple/UMDNTuple/interface/PhotonProducer.h"
 #include "FWCore/Framework/interface/EDConsumerBase.h"
 #include "FWCore/Framework/interface/Event.h"
-#include "RecoEgamma/EgammaTools/interface/EffectiveAreas.h"
 
 PhotonProducer::PhotonProducer(  ) : 
-    ph_n(0),
-    ph_pt(0),
-    ph_eta(0),
-    ph_phi(0),
-    ph_e(0),
-    ph_ptOrig(0),
-    ph_etaOrig(0),
-    ph_phiOrig(0),
-    ph_eOrig(0),
-    ph_passVIDLoose(0),
-    ph_passVIDMedium(0),
-    ph_passVIDTight(0),
-    ph_chIso(0),
-    ph_neuIso(0),
-    ph_phoIso(0),
-    ph_chIsoCorr(0),
-    ph_neuIsoCorr(0),
-    ph_phoIsoCorr(0),
-    ph_aeffch(0),
-    ph_aeffnh(0),
-    ph_aeffph(0),
-    ph_sc_eta(0),
-    ph_sc_phi(0),
-    ph_hOverE(0),
-    ph_hOverE_hdronic(0),
-    ph_sigmaIEIE(0),
-    ph_sigmaIEIEFull5x5(0),
-    ph_r9(0),
-    ph_r9Full5x5(0),
-    ph_etaWidth(0),
-    ph_phiWidth(0),
-    ph_passEleVeto(0),
-    ph_hasPixSeed(0),
-    ph_sc_rawE(0),
-    ph_ecalIso(0),
-    ph_hcalIso(0),
-    ph_trkIso(0),
-    ph_pfIsoPUChHad(0),
-    ph_pfIsoEcal(0),
-    ph_pfIsoHcal(0),
-    ph_E3x3(0),
-    ph_E1x5(0),
-    ph_E2x5(0),
-    ph_E5x5(0),
     //ph_sigmaIetaIphi(0),
     //ph_sigmaIphiIphi(0),
-    ph_E1x5Full5x5(0),
-    ph_E2x5Full5x5(0),
-    ph_E3x3Full5x5(0),
-    ph_E5x5Full5x5(0),
-    _effectiveAreasCH("src/UMDNTuple/UMDNTuple/data/effAreaPhotons_cone03_pfChargedHadrons_90percentBased_V2.txt"),
-    _effectiveAreasNH("src/UMDNTuple/UMDNTuple/data/effAreaPhotons_cone03_pfNeutralHadrons_90percentBased_V2.txt"),
-    _effectiveAreasPH("src/UMDNTuple/UMDNTuple/data/effAreaPhotons_cone03_pfPhotons_90percentBased_V2.txt"),
+    _effectiveAreas( EffectiveAreaTable::photons() ),
+    _isolation( 3 ),
+    _sortByPt(false),
+    ph_origIdx(0),
     _detail(0),
     _tree(0)
 {
@@ -65,7 +17,8 @@ PhotonProducer::PhotonProducer(  ) :
 
 void PhotonProducer::initialize( const std::string &prefix,
                                  const edm::EDGetTokenT<edm::View<pat::Photon> >&photTok,
-                                 TTree *tree, float minPt, int detail) {
+                                 TTree *tree, float minPt, int detail,
+                                 const BranchSelection &selection ) {
 
     _prefix = prefix;
     _photToken = photTok;
@@ -73,74 +26,67 @@ void PhotonProducer::initialize( const std::string &prefix,
     _tree = tree;
     _minPt = minPt;
 
-    tree->Branch( (prefix + "_n" ).c_str(), &ph_n,(prefix + "_n/I" ).c_str()  );
-
-    tree->Branch( (prefix + "_pt" ).c_str(), &ph_pt );
-    tree->Branch( (prefix + "_eta").c_str(), &ph_eta );
-    tree->Branch( (prefix + "_phi").c_str(), &ph_phi );
-    tree->Branch( (prefix + "_e"  ).c_str(), &ph_e );
-    tree->Branch( (prefix + "_ptOrig" ).c_str(), &ph_ptOrig );
-    tree->Branch( (prefix + "_etaOrig").c_str(), &ph_etaOrig );
-    tree->Branch( (prefix + "_phiOrig").c_str(), &ph_phiOrig );
-    tree->Branch( (prefix + "_eOrig"  ).c_str(), &ph_eOrig );
-
-    if( detail > 0 ) {
-
-        tree->Branch( (prefix + "_passVIDLoose").c_str(), &ph_passVIDLoose );
-        tree->Branch( (prefix + "_passVIDMedium").c_str(), &ph_passVIDMedium );
-        tree->Branch( (prefix + "_passVIDTight").c_str(), &ph_passVIDTight );
-
-        tree->Branch( (prefix + "_chIso").c_str(), &ph_chIso );
-        tree->Branch( (prefix + "_neuIso").c_str(), &ph_neuIso );
-        tree->Branch( (prefix + "_phoIso").c_str(), &ph_phoIso );
-
-        tree->Branch( (prefix + "_chIsoCorr").c_str(), &ph_chIsoCorr );
-        tree->Branch( (prefix + "_neuIsoCorr").c_str(), &ph_neuIsoCorr );
-        tree->Branch( (prefix + "_phoIsoCorr").c_str(), &ph_phoIsoCorr );
-
-        tree->Branch( (prefix + "_aeffch").c_str(), &ph_aeffch );
-        tree->Branch( (prefix + "_aeffnh").c_str(), &ph_aeffnh );
-        tree->Branch( (prefix + "_aeffph").c_str(), &ph_aeffph );
-
-        tree->Branch( (prefix + "_sc_eta").c_str(), &ph_sc_eta );
-        tree->Branch( (prefix + "_sc_phi").c_str(), &ph_sc_phi );
-
-        tree->Branch( (prefix + "_hOverE").c_str(), &ph_hOverE );
-        tree->Branch( (prefix + "_hOverE_hadronic").c_str(), &ph_hOverE_hdronic);
-        tree->Branch( (prefix + "_sigmaIEIE").c_str(), &ph_sigmaIEIE );
-        tree->Branch( (prefix + "_sigmaIEIEFull5x5").c_str(), &ph_sigmaIEIEFull5x5 );
-        tree->Branch( (prefix + "_r9").c_str(), &ph_r9 );
-        tree->Branch( (prefix + "_r9Full5x5").c_str(), &ph_r9Full5x5 );
-        tree->Branch( (prefix + "_etaWidth").c_str(), &ph_etaWidth );
-        tree->Branch( (prefix + "_phiWidth").c_str(), &ph_phiWidth );
-
-        tree->Branch( (prefix + "_passEleVeto").c_str(), &ph_passEleVeto  );
-        tree->Branch( (prefix + "_hasPixSeed").c_str(), &ph_hasPixSeed  );
-
-        if( detail > 1 ) {
-
-            tree->Branch( (prefix + "_sc_rawE").c_str(), &ph_sc_rawE );
-
-            tree->Branch( (prefix + "_ecalIso").c_str(), &ph_ecalIso );
-            tree->Branch( (prefix + "_hcalIso").c_str(), &ph_hcalIso );
-            tree->Branch( (prefix + "_trkIso").c_str(), &ph_trkIso );
-            tree->Branch( (prefix + "_pfIsoPUChHad").c_str(), &ph_pfIsoPUChHad );
-            tree->Branch( (prefix + "_pfIsoEcal").c_str(), &ph_pfIsoEcal );
-            tree->Branch( (prefix + "_pfIsoHcal").c_str(), &ph_pfIsoHcal );
-            tree->Branch( (prefix + "_E3x3").c_str(), &ph_E3x3 );
-            tree->Branch( (prefix + "_E1x5").c_str(), &ph_E1x5 );
-            tree->Branch( (prefix + "_E2x5").c_str(), &ph_E2x5 );
-            tree->Branch( (prefix + "_E5x5").c_str(), &ph_E5x5 );
-            //tree->Branch( (prefix + "_sigmaIetaIphi").c_str(), &ph_sigmaIetaIphi );
-            //tree->Branch( (prefix + "_sigmaIphiIphi").c_str(), &ph_sigmaIphiIphi );
-
-            tree->Branch( (prefix + "_E1x5Full5x5").c_str(), &ph_E1x5Full5x5 );
-            tree->Branch( (prefix + "_E2x5Full5x5").c_str(), &ph_E2x5Full5x5 );
-            tree->Branch( (prefix + "_E3x3Full5x5").c_str(), &ph_E3x3Full5x5 );
-            tree->Branch( (prefix + "_E5x5Full5x5").c_str(), &ph_E5x5Full5x5 );
-        }
-    }
-
+    _columns.initialize( prefix, tree, detail, selection );
+
+    ph_pt = _columns.add<float>( "pt" );
+    ph_eta = _columns.add<float>( "eta" );
+    ph_phi = _columns.add<float>( "phi" );
+    ph_e = _columns.add<float>( "e" );
+    ph_ptOrig = _columns.add<float>( "ptOrig" );
+    ph_etaOrig = _columns.add<float>( "etaOrig" );
+    ph_phiOrig = _columns.add<float>( "phiOrig" );
+    ph_eOrig = _columns.add<float>( "eOrig" );
+
+    ph_passVIDLoose = _columns.add<Bool_t>( "passVIDLoose", 1 );
+    ph_passVIDMedium = _columns.add<Bool_t>( "passVIDMedium", 1 );
+    ph_passVIDTight = _columns.add<Bool_t>( "passVIDTight", 1 );
+
+    ph_chIso = _columns.add<float>( "chIso", 1 );
+    ph_neuIso = _columns.add<float>( "neuIso", 1 );
+    ph_phoIso = _columns.add<float>( "phoIso", 1 );
+
+    ph_chIsoCorr = _columns.add<float>( "chIsoCorr", 1 );
+    ph_neuIsoCorr = _columns.add<float>( "neuIsoCorr", 1 );
+    ph_phoIsoCorr = _columns.add<float>( "phoIsoCorr", 1 );
+
+    ph_aeffch = _columns.add<float>( "aeffch", 1 );
+    ph_aeffnh = _columns.add<float>( "aeffnh", 1 );
+    ph_aeffph = _columns.add<float>( "aeffph", 1 );
+
+    ph_sc_eta = _columns.add<float>( "sc_eta", 1 );
+    ph_sc_phi = _columns.add<float>( "sc_phi", 1 );
+
+    ph_hOverE = _columns.add<float>( "hOverE", 1 );
+    ph_hOverE_hdronic = _columns.add<float>( "hOverE_hadronic", 1 );
+    ph_sigmaIEIE = _columns.add<float>( "sigmaIEIE", 1 );
+    ph_sigmaIEIEFull5x5 = _columns.add<float>( "sigmaIEIEFull5x5", 1 );
+    ph_r9 = _columns.add<float>( "r9", 1 );
+    ph_r9Full5x5 = _columns.add<float>( "r9Full5x5", 1 );
+    ph_etaWidth = _columns.add<float>( "etaWidth", 1 );
+    ph_phiWidth = _columns.add<float>( "phiWidth", 1 );
+
+    ph_passEleVeto = _columns.add<Bool_t>( "passEleVeto", 1 );
+    ph_hasPixSeed = _columns.add<Bool_t>( "hasPixSeed", 1 );
+
+    ph_sc_rawE = _columns.add<float>( "sc_rawE", 2 );
+
+    ph_ecalIso = _columns.add<float>( "ecalIso", 2 );
+    ph_hcalIso = _columns.add<float>( "hcalIso", 2 );
+    ph_trkIso = _columns.add<float>( "trkIso", 2 );
+    ph_pfIsoPUChHad = _columns.add<float>( "pfIsoPUChHad", 2 );
+    ph_pfIsoEcal = _columns.add<float>( "pfIsoEcal", 2 );
+    ph_pfIsoHcal = _columns.add<float>( "pfIsoHcal", 2 );
+    ph_E3x3 = _columns.add<float>( "E3x3", 2 );
+    ph_E1x5 = _columns.add<float>( "E1x5", 2 );
+    ph_E2x5 = _columns.add<float>( "E2x5", 2 );
+    ph_E5x5 = _columns.add<float>( "E5x5", 2 );
+    //ph_sigmaIetaIphi = _columns.add<float>( "sigmaIetaIphi", 2 );
+    //ph_sigmaIphiIphi = _columns.add<float>( "sigmaIphiIphi", 2 );
+
+    ph_E1x5Full5x5 = _columns.add<float>( "E1x5Full5x5", 2 );
+    ph_E2x5Full5x5 = _columns.add<float>( "E2x5Full5x5", 2 );
+    ph_E3x3Full5x5 = _columns.add<float>( "E3x3Full5x5", 2 );
+    ph_E5x5Full5x5 = _columns.add<float>( "E5x5Full5x5", 2 );
 }
 
 void PhotonProducer::addUserString( PhotonUserVar type, const std::string userString) {
@@ -156,27 +102,27 @@ void PhotonProducer::addUserString( PhotonUserVar type, const std::string userSt
         _PhoIso = userString;
     }
     // id
+    std::vector<Bool_t> *column = 0;
     if( type == PhotonVIDLoose ){
         _VIDLoose = userString;
+        column = ph_passVIDLoose;
     }
     if( type == PhotonVIDMedium ){
         _VIDMedium = userString;
+        column = ph_passVIDMedium;
     }
     if( type == PhotonVIDTight ){
         _VIDTight = userString;
+        column = ph_passVIDTight;
+    }
+
+    // dropped ids are not looked up
+    if( column && _columns.booked( column ) ) {
+        _ids.push_back( std::make_pair( column, _idIndex.add( userString ) ) );
     }
 
 }
         
-void PhotonProducer::addConversionsToken( const edm::EDGetTokenT<reco::ConversionCollection> & tok) {
-    _ConversionsToken = tok;
-}
-void PhotonProducer::addBeamSpotToken( const edm::EDGetTokenT<reco::BeamSpot> & tok) {
-    _beamSpotToken= tok;
-}
-void PhotonProducer::addRhoToken( const edm::EDGetTokenT<double> & tok) {
-    _rhoToken = tok;
-}
 //void PhotonProducer::addElectronsToken( const edm::EDGetTokenT<edm::View<pat::Electron> > & tok) {
 //    _ElectronsToken = tok;
 //}
@@ -185,179 +131,134 @@ void PhotonProducer::addEnergyCalib( const std::string eneCalib) {
       _eneCalib = eneCalib;
 }
 
-void PhotonProducer::produce(const edm::Event &iEvent ) {
-
-    ph_n=0;
-    ph_pt->clear();
-    ph_eta->clear();
-    ph_phi->clear();
-    ph_e->clear();
-    ph_ptOrig->clear();
-    ph_etaOrig->clear();
-    ph_phiOrig->clear();
-    ph_eOrig->clear();
-
-    if( _detail > 0 ) {
-
-        ph_passVIDLoose->clear();
-        ph_passVIDMedium->clear();
-        ph_passVIDTight->clear();
-
-        ph_chIso->clear();
-        ph_neuIso->clear();
-        ph_phoIso->clear();
-
-        ph_chIsoCorr->clear();
-        ph_neuIsoCorr->clear();
-        ph_phoIsoCorr->clear();
-
-        ph_aeffch->clear();
-        ph_aeffnh->clear();
-        ph_aeffph->clear();
-
-        ph_sc_eta ->clear();
-        ph_sc_phi ->clear();
-
-        ph_hOverE->clear();
-        ph_hOverE_hdronic->clear();
-        ph_sigmaIEIE->clear();
-        ph_sigmaIEIEFull5x5->clear();
-        ph_r9->clear();
-        ph_r9Full5x5->clear();
-        ph_etaWidth->clear();
-        ph_phiWidth->clear();
-
-        ph_passEleVeto ->clear();
-        ph_hasPixSeed ->clear();
-
-        if( _detail > 1 ) {
-            ph_sc_rawE->clear();
-
-            ph_ecalIso->clear();
-            ph_hcalIso->clear();
-            ph_trkIso->clear();
-            ph_pfIsoPUChHad->clear();
-            ph_pfIsoEcal->clear();
-            ph_pfIsoHcal->clear();
-            ph_E3x3->clear();
-            ph_E1x5->clear();
-            ph_E2x5->clear();
-            ph_E5x5->clear();
-            //ph_sigmaIetaIphi->clear();
-            //ph_sigmaIphiIphi->clear();
-
-            ph_E1x5Full5x5->clear();
-            ph_E2x5Full5x5->clear();
-            ph_E3x3Full5x5->clear();
-            ph_E5x5Full5x5->clear();
-        }
-    }
+void PhotonProducer::sortByCalibratedPt() {
+
+    _sortByPt = true;
+    ph_origIdx = _columns.add<int>( "origIdx" );
+}
+
+void PhotonProducer::produce(const edm::Event &iEvent, const EventContext &context ) {
+
+    _columns.clear();
 
     edm::Handle<edm::View<pat::Photon> > photons;
     iEvent.getByToken(_photToken,photons);
+    _columns.reserve( photons->size() );
+    _idIndex.reset();
 
-    const std::string ph_VIDLoose_str  = _VIDLoose;
-    const std::string ph_VIDMedium_str = _VIDMedium;
-    const std::string ph_VIDTight_str  = _VIDTight;
-
-    const std::string ph_chIso_str  = _ChIso;
-    const std::string ph_neuIso_str = _NeuIso; 
-    const std::string ph_phoIso_str = _PhoIso;
+    const std::string & ph_chIso_str  = _ChIso;
+    const std::string & ph_neuIso_str = _NeuIso;
+    const std::string & ph_phoIso_str = _PhoIso;
 
-    const std::string phoEneCalib_str = _eneCalib;
+    const std::string & phoEneCalib_str = _eneCalib;
 
     //edm::Handle<edm::View<pat::Electron> > electrons_h;
     //iEvent.getByToken(_ElectronsToken, electrons_h);
 
-    edm::Handle<reco::ConversionCollection> conversions_h;
-    iEvent.getByToken(_ConversionsToken, conversions_h);
-
-    edm::Handle<reco::BeamSpot> beamSpot_h;
-    iEvent.getByToken(_beamSpotToken, beamSpot_h);
-
-    edm::Handle<double> rho_h;
-    iEvent.getByToken( _rhoToken, rho_h);
+    const double rhoPrime = context.rhoPrime();
 
     // needed for a few shower shape variables
     // do not use for now
     //EcalClusterLazyTools lazyTool(iEvent, iSetup, ecalHitEBToken_, ecalHitEEToken_, ecalHitESToken_ );
 
+    // collect the inputs of the calibrated kinematics and of the
+    // corrected isolation, both are computed for all photons at once
+    _kinematics.clear();
+    _kinematics.reserve( photons->size() );
+    _isolation.clear();
+    _isolation.reserve( photons->size() );
+    _absEta.clear();
     for (unsigned int j=0; j < photons->size();++j){
-        edm::Ptr<pat::Photon> ph = photons->ptrAt(j);
+        const pat::Photon & ph = photons->at(j);
+        if( ph.pt() < _minPt ) continue;
+
+        _kinematics.add( ph, ph.userFloat( phoEneCalib_str ) );
+
+        if( _detail > 0 ) {
+            const float iso[3] = { ph.userFloat( ph_chIso_str  ),
+                                   ph.userFloat( ph_neuIso_str ),
+                                   ph.userFloat( ph_phoIso_str ) };
+            _isolation.add( iso );
+            _absEta.push_back( fabs(ph.superCluster()->eta()) );
+        }
+    }
+    _kinematics.compute();
+    _effectiveAreas.areas( _absEta, _areas );
+    _isolation.compute( _areas, rhoPrime );
+
+    for (unsigned int j=0; j < photons->size();++j){
+        const pat::Photon & ph = photons->at(j);
  
-        if( ph->pt() < _minPt ) continue;
+        if( ph.pt() < _minPt ) continue;
+
+        const unsigned idx = _columns.size();
 
-        ph_n += 1;
+        if( _sortByPt ) ph_origIdx->push_back( j );
 
-        ph_ptOrig  -> push_back( ph->pt() );
-        ph_etaOrig -> push_back( ph->eta() );
-        ph_phiOrig -> push_back( ph->phi() );
-        ph_eOrig   -> push_back( ph->energy() );
+        ph_ptOrig  -> push_back( ph.pt() );
+        ph_etaOrig -> push_back( ph.eta() );
+        ph_phiOrig -> push_back( ph.phi() );
+        ph_eOrig   -> push_back( ph.energy() );
 
-        auto calibp4 = ph->p4() * ph->userFloat( phoEneCalib_str )/ph->energy() ;
-        ph_pt ->push_back( calibp4.Pt() );
-        ph_eta -> push_back( calibp4.Eta() );
-        ph_phi -> push_back( calibp4.phi() );
-        ph_e -> push_back( calibp4.E() );
+        ph_pt ->push_back( _kinematics.pt( idx ) );
+        ph_eta -> push_back( _kinematics.eta( idx ) );
+        ph_phi -> push_back( _kinematics.phi( idx ) );
+        ph_e -> push_back( _kinematics.e( idx ) );
 
         if( _detail > 0 ) {
 
-            ph_passVIDLoose -> push_back(  ph->photonID( ph_VIDLoose_str  ) );
-            ph_passVIDMedium -> push_back( ph->photonID( ph_VIDMedium_str ) );
-            ph_passVIDTight -> push_back(  ph->photonID( ph_VIDTight_str  ) );
+            const std::vector<pat::Photon::IdPair> & ids = ph.photonIDs();
+            for( std::vector<std::pair<std::vector<Bool_t>*, unsigned> >::const_iterator itr = _ids.begin();
+                    itr != _ids.end(); ++itr ) {
+                itr->first->push_back( _idIndex.value( ids, itr->second ) );
+            }
 
-            float chIso  = ph->userFloat( ph_chIso_str  ) ;
-            float neuIso = ph->userFloat( ph_neuIso_str ) ;
-            float phoIso = ph->userFloat( ph_phoIso_str ) ;
-            ph_chIso -> push_back(  chIso );
-            ph_neuIso -> push_back( neuIso );
-            ph_phoIso -> push_back( phoIso );
+            ph_chIso -> push_back(  _isolation.raw( idx, 0 ) );
+            ph_neuIso -> push_back( _isolation.raw( idx, 1 ) );
+            ph_phoIso -> push_back( _isolation.raw( idx, 2 ) );
 
             // Rho corrected isolation
             // followed instructions from
             // https://twiki.cern.ch/twiki/bin/view/CMS/CutBasedPhotonIdentificationRun2#Selection_implementation_details
             // and the implementations from ElectronProducer.cc
-            double rhoPrime = std::max(0., *rho_h);
-            float eACH = _effectiveAreasCH.getEffectiveArea( fabs(ph->superCluster()->eta()) );
-            float eANH = _effectiveAreasNH.getEffectiveArea( fabs(ph->superCluster()->eta()) );
-            float eAPH = _effectiveAreasPH.getEffectiveArea( fabs(ph->superCluster()->eta()) );
-            ph_aeffch->push_back( eACH );
-            ph_aeffnh->push_back( eANH );
-            ph_aeffph->push_back( eAPH );
-            ph_chIsoCorr ->push_back( std::max(0.0,  chIso   - rhoPrime*(eACH))  );
-            ph_neuIsoCorr->push_back( std::max(0.0,  neuIso  - rhoPrime*(eANH))  );
-            ph_phoIsoCorr ->push_back( std::max(0.0, phoIso  - rhoPrime*(eAPH))  );
-
-            ph_sc_eta ->push_back(ph->superCluster()->eta());
-            ph_sc_phi ->push_back(ph->superCluster()->phi());
+            const float *eA = &_areas[ idx*_effectiveAreas.nAreas() ];
+            ph_aeffch->push_back( eA[0] );
+            ph_aeffnh->push_back( eA[1] );
+            ph_aeffph->push_back( eA[2] );
+            ph_chIsoCorr ->push_back( _isolation.corrected( idx, 0 ) );
+            ph_neuIsoCorr->push_back( _isolation.corrected( idx, 1 ) );
+            ph_phoIsoCorr ->push_back( _isolation.corrected( idx, 2 ) );
+
+            ph_sc_eta ->push_back(ph.superCluster()->eta());
+            ph_sc_phi ->push_back(ph.superCluster()->phi());
 
             // update according to 
             // https://twiki.cern.ch/twiki/bin/view/CMS/CutBasedPhotonIdentificationRun2#Selection_implementation_details
             // https://github.com/cms-sw/cmssw/blob/CMSSW_9_0_X/RecoEgamma/PhotonIdentification/plugins/cuts/PhoHadronicOverEMCut.cc#L36
             // there was a bug in the Photon ID twiki. The hoverE is supposed to be hadTowOverEm
-            ph_hOverE->push_back(ph->hadTowOverEm());
+            ph_hOverE->push_back(ph.hadTowOverEm());
             // save the wrong one just in case it is useful
-            ph_hOverE_hdronic->push_back(ph->hadronicOverEm());
-            ph_sigmaIEIE->push_back(ph->sigmaIetaIeta());
-            ph_sigmaIEIEFull5x5->push_back(ph->full5x5_sigmaIetaIeta());
-            ph_r9->push_back(ph->r9());
-            ph_r9Full5x5->push_back(ph->full5x5_r9());   
-            ph_etaWidth->push_back(ph->superCluster()->etaWidth());
-            ph_phiWidth->push_back(ph->superCluster()->phiWidth());
+            ph_hOverE_hdronic->push_back(ph.hadronicOverEm());
+            ph_sigmaIEIE->push_back(ph.sigmaIetaIeta());
+            ph_sigmaIEIEFull5x5->push_back(ph.full5x5_sigmaIetaIeta());
+            ph_r9->push_back(ph.r9());
+            ph_r9Full5x5->push_back(ph.full5x5_r9());   
+            ph_etaWidth->push_back(ph.superCluster()->etaWidth());
+            ph_phiWidth->push_back(ph.superCluster()->phiWidth());
 
-            ph_passEleVeto -> push_back (ph->passElectronVeto());
-            ph_hasPixSeed -> push_back( ph->hasPixelSeed());
+            ph_passEleVeto -> push_back (ph.passElectronVeto());
+            ph_hasPixSeed -> push_back( ph.hasPixelSeed());
 
             if( _detail > 1 ) {
 
-                ph_sc_rawE->push_back(ph->superCluster()->rawEnergy());
+                ph_sc_rawE->push_back(ph.superCluster()->rawEnergy());
 
-                ph_ecalIso->push_back(ph->ecalIso());
-                ph_hcalIso->push_back(ph->hcalIso());
-                ph_trkIso->push_back(ph->trackIso());
-                ph_pfIsoPUChHad->push_back(ph->puChargedHadronIso());
-                ph_pfIsoEcal->push_back(ph->ecalPFClusterIso());
-                ph_pfIsoHcal->push_back(ph->hcalPFClusterIso());
+                ph_ecalIso->push_back(ph.ecalIso());
+                ph_hcalIso->push_back(ph.hcalIso());
+                ph_trkIso->push_back(ph.trackIso());
+                ph_pfIsoPUChHad->push_back(ph.puChargedHadronIso());
+                ph_pfIsoEcal->push_back(ph.ecalPFClusterIso());
+                ph_pfIsoHcal->push_back(ph.hcalPFClusterIso());
 
                 // requires implementation fo lazy tools
                 //const reco::CaloClusterPtr  seed_clu = photon.superCluster()->seed();
@@ -365,19 +266,25 @@ void PhotonProducer::produce(const edm::Event &iEvent ) {
                 //ph_E2x2->push_back( lazyTool.e2x2( *seed_clu ) );
                 //ph_S4->push_back( lazyTool.e2x2( *seed_clu ) / lazyTool.e5x5( *seed_clu ) );
                 ////photon cluster shape
-                ph_E3x3->push_back(ph->e3x3());
-                ph_E1x5->push_back(ph->e1x5());
-                ph_E2x5->push_back(ph->e2x5());
-                ph_E5x5->push_back(ph->e5x5());
-                //ph_sigmaIetaIphi->push_back(ph->sigmaIetaIphi());
-                //ph_sigmaIphiIphi->push_back(ph->sigmaIphiIphi());
-
-                ph_E1x5Full5x5->push_back(ph->full5x5_e1x5());    
-                ph_E2x5Full5x5->push_back(ph->full5x5_e2x5());
-                ph_E3x3Full5x5->push_back(ph->full5x5_e3x3());
-                ph_E5x5Full5x5->push_back(ph->full5x5_e5x5());
+                ph_E3x3->push_back(ph.e3x3());
+                ph_E1x5->push_back(ph.e1x5());
+                ph_E2x5->push_back(ph.e2x5());
+                ph_E5x5->push_back(ph.e5x5());
+                //ph_sigmaIetaIphi->push_back(ph.sigmaIetaIphi());
+                //ph_sigmaIphiIphi->push_back(ph.sigmaIphiIphi());
+
+                ph_E1x5Full5x5->push_back(ph.full5x5_e1x5());    
+                ph_E2x5Full5x5->push_back(ph.full5x5_e2x5());
+                ph_E3x3Full5x5->push_back(ph.full5x5_e3x3());
+                ph_E5x5Full5x5->push_back(ph.full5x5_e5x5());
             }
         }
+
+        _columns.endObject();
+    }
+
+    if( _sortByPt && _kinematics.ptOrder( _order ) ) {
+        _columns.permute( _order );
     }
 }
     //for( std::map< std::string, edm::EDGetTokenT<edm::ValueMap<Bool_t> > >::const_iterator itr = _tokens_bool.begin(); itr != _tokens_bool.end(); ++itr ) {
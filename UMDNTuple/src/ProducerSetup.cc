@@ -0,0 +1,307 @@
+#include "UMDNTuple/UMDNTuple/interface/ProducerSetup.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DataFormats/Common/interface/TriggerResults.h"
+
+std::string ProducerSetup::prefix( const edm::ParameterSet & iConfig,
+                                   const std::string &name, const std::string &def ) {
+
+    if( iConfig.exists(name) ) {
+        return iConfig.getUntrackedParameter<std::string>(name);
+    }
+    return def;
+}
+
+float ProducerSetup::minPt( const edm::ParameterSet & iConfig, const std::string &name ) {
+
+    if( iConfig.exists(name) ) {
+        return iConfig.getUntrackedParameter<double>(name);
+    }
+    return 0;
+}
+
+bool ProducerSetup::bitmask( const edm::ParameterSet & iConfig ) {
+
+    if( iConfig.exists("triggerBitmask") ) {
+        return iConfig.getUntrackedParameter<bool>("triggerBitmask");
+    }
+    return false;
+}
+
+BranchSelection ProducerSetup::selection( const edm::ParameterSet & iConfig ) {
+
+    // a column is computed if any output writes it
+    if( !iConfig.exists("outputs") ) return BranchSelection( iConfig );
+
+    BranchSelection selection;
+    std::vector<edm::ParameterSet> outputs =
+        iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("outputs");
+    for( std::vector<edm::ParameterSet>::const_iterator itr = outputs.begin();
+            itr != outputs.end(); ++itr ) {
+        selection.merge( BranchSelection( *itr ) );
+    }
+    return selection;
+}
+
+bool ProducerSetup::sortByPt( const edm::ParameterSet & iConfig, const std::string &name ) {
+
+    if( iConfig.exists(name) ) {
+        return iConfig.getUntrackedParameter<bool>(name);
+    }
+    return false;
+}
+
+int ProducerSetup::detail( const edm::ParameterSet & iConfig, const std::string &name ) {
+
+    if( iConfig.exists(name) ) {
+        return iConfig.getUntrackedParameter<int>(name);
+    }
+    return 99;
+}
+
+void ProducerSetup::setup( EventContext & context, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC ) {
+
+    edm::EDGetTokenT<std::vector<reco::Vertex> > verticesToken;
+    edm::EDGetTokenT<double> rhoToken;
+    edm::EDGetTokenT<reco::BeamSpot> beamSpotToken;
+    edm::EDGetTokenT<reco::ConversionCollection> conversionsToken;
+
+    if( iConfig.exists("verticesTag") ) {
+        verticesToken = iC.consumes<std::vector<reco::Vertex> >(
+                 iConfig.getUntrackedParameter<edm::InputTag>("verticesTag"));
+    }
+    if( iConfig.exists("rhoTag") ) {
+        rhoToken = iC.consumes<double>(
+                 iConfig.getUntrackedParameter<edm::InputTag>("rhoTag"));
+    }
+    if( iConfig.exists("beamSpotTag" ) ) {
+        beamSpotToken = iC.consumes<reco::BeamSpot>(
+                 iConfig.getUntrackedParameter<edm::InputTag>("beamSpotTag"));
+    }
+    if( iConfig.exists("conversionsTag") ) {
+        conversionsToken = iC.consumes<reco::ConversionCollection>(
+                 iConfig.getUntrackedParameter<edm::InputTag>("conversionsTag"));
+    }
+
+    context.initialize( verticesToken, rhoToken, beamSpotToken, conversionsToken );
+}
+
+void ProducerSetup::setup( EventInfoProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree *infoTree ) {
+
+    if( !iConfig.exists( "isMC" ) ) {
+        throw cms::Exception("CorruptData")
+        << "Must provide isMC flag so we can handle the data/MC properly";
+    }
+
+    int isMC = iConfig.getUntrackedParameter<int>("isMC");
+    bool doPref = iConfig.getUntrackedParameter<bool>("doPref");
+
+    bool disableEventWeights = false;
+    if( iConfig.exists("disableEventWeights" ) ) {
+        disableEventWeights = iConfig.getUntrackedParameter<bool>("disableEventWeights");
+    }
+
+    edm::EDGetTokenT<std::vector<PileupSummaryInfo> > puToken;
+    edm::EDGetTokenT<GenEventInfoProduct> generatorToken;
+    edm::EDGetTokenT<double> prefweight_token;
+    edm::EDGetTokenT<double> prefweightup_token;
+    edm::EDGetTokenT<double> prefweightdown_token;
+    edm::EDGetTokenT<LHEEventProduct> lheEventToken;
+    edm::EDGetTokenT<LHERunInfoProduct> lheRunToken;
+
+    if( iConfig.exists("puTag") ) {
+        puToken = iC.consumes<std::vector<PileupSummaryInfo> >(
+                 iConfig.getUntrackedParameter<edm::InputTag>("puTag"));
+    }
+    if( iConfig.exists("generatorTag") ) {
+        generatorToken = iC.consumes<GenEventInfoProduct>(
+                 iConfig.getUntrackedParameter<edm::InputTag>("generatorTag"));
+    }
+    if( iConfig.exists("prefTag") && isMC) {
+	prefweight_token = iC.consumes< double >(
+		  iConfig.getUntrackedParameter<edm::InputTag>("prefTag"));
+	prefweightup_token = iC.consumes< double >(
+		  iConfig.getUntrackedParameter<edm::InputTag>("prefupTag"));
+	prefweightdown_token = iC.consumes< double >(
+		  iConfig.getUntrackedParameter<edm::InputTag>("prefdownTag"));
+    }
+    if( iConfig.exists("lheEventTag") ) {
+        lheEventToken = iC.consumes<LHEEventProduct>(
+                 iConfig.getUntrackedParameter<edm::InputTag>("lheEventTag"));
+    }
+    if( iConfig.exists("lheRunTag") ) {
+        lheRunToken = iC.consumes<LHERunInfoProduct, edm::InRun>(
+                 iConfig.getUntrackedParameter<edm::InputTag>("lheRunTag"));
+    }
+
+    producer.initialize( puToken,
+                         generatorToken, lheEventToken, lheRunToken,
+                         prefweight_token, prefweightup_token, prefweightdown_token,
+                         tree, infoTree, isMC , doPref);
+
+    if(disableEventWeights ) {
+        producer.disableEventWeights();
+    }
+}
+
+void ProducerSetup::setup( ElectronProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree * ) {
+
+    edm::EDGetTokenT<edm::View<pat::Electron> > elecToken =  iC.consumes<edm::View<pat::Electron> >(
+                 iConfig.getUntrackedParameter<edm::InputTag>("electronTag"));
+
+    producer.initialize( prefix( iConfig, "prefix_el", "el" ), elecToken, tree,
+                         minPt( iConfig, "electronMinPt" ), detail( iConfig, "electronDetailLevel" ),
+                         selection( iConfig ) );
+
+    std::string elecIdVeryLoose = iConfig.getUntrackedParameter<std::string>("elecIdVeryLooseStr");
+    std::string elecIdLoose     = iConfig.getUntrackedParameter<std::string>("elecIdLooseStr");
+    std::string elecIdMedium    = iConfig.getUntrackedParameter<std::string>("elecIdMediumStr");
+    std::string elecIdTight     = iConfig.getUntrackedParameter<std::string>("elecIdTightStr");
+    std::string elecIdHEEP      = iConfig.getUntrackedParameter<std::string>("elecIdHEEPStr");
+
+    producer.addUserString( ElectronIdVeryLoose , elecIdVeryLoose);
+    producer.addUserString( ElectronIdLoose     , elecIdLoose);
+    producer.addUserString( ElectronIdMedium    , elecIdMedium);
+    producer.addUserString( ElectronIdTight     , elecIdTight);
+    producer.addUserString( ElectronIdHEEP      , elecIdHEEP);
+
+    std::string elecEneCalib = iConfig.getUntrackedParameter<std::string>("elecEneCalibStr");
+    producer.addEnergyCalib( elecEneCalib );
+
+    if( sortByPt( iConfig, "electronSortByPt" ) ) producer.sortByCalibratedPt();
+}
+
+void ProducerSetup::setup( MuonProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree * ) {
+
+    edm::EDGetTokenT<edm::View<pat::Muon> > muonToken = iC.consumes<edm::View<pat::Muon> >(
+                iConfig.getUntrackedParameter<edm::InputTag>("muonTag"));
+
+    producer.initialize( prefix( iConfig, "prefix_mu", "mu" ), muonToken, tree,
+                         minPt( iConfig, "muonMinPt" ), detail( iConfig, "muonDetailLevel" ),
+                         selection( iConfig ) );
+}
+
+void ProducerSetup::setup( PhotonProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree * ) {
+
+    edm::EDGetTokenT<edm::View<pat::Photon> > photToken = iC.consumes<edm::View<pat::Photon> >(
+                iConfig.getUntrackedParameter<edm::InputTag>("photonTag"));
+
+    producer.initialize( prefix( iConfig, "prefix_ph", "ph" ), photToken, tree,
+                         minPt( iConfig, "photonMinPt" ), detail( iConfig, "photonDetailLevel" ),
+                         selection( iConfig ) );
+
+    std::string phoChIso  = iConfig.getUntrackedParameter<std::string>("phoChIsoStr");
+    std::string phoNeuIso = iConfig.getUntrackedParameter<std::string>("phoNeuIsoStr");
+    std::string phoPhoIso = iConfig.getUntrackedParameter<std::string>("phoPhoIsoStr");
+    std::string phoIdLoose  = iConfig.getUntrackedParameter<std::string>("phoIdLooseStr");
+    std::string phoIdMedium = iConfig.getUntrackedParameter<std::string>("phoIdMediumStr");
+    std::string phoIdTight  = iConfig.getUntrackedParameter<std::string>("phoIdTightStr");
+
+    producer.addUserString( PhotonChIso        , phoChIso  );
+    producer.addUserString( PhotonNeuIso       , phoNeuIso );
+    producer.addUserString( PhotonPhoIso       , phoPhoIso );
+    producer.addUserString( PhotonVIDLoose      , phoIdLoose  );
+    producer.addUserString( PhotonVIDMedium     , phoIdMedium );
+    producer.addUserString( PhotonVIDTight      , phoIdTight  );
+
+    std::string phoEneCalib = iConfig.getUntrackedParameter<std::string>("phoEneCalibStr");
+    producer.addEnergyCalib( phoEneCalib );
+
+    if( sortByPt( iConfig, "photonSortByPt" ) ) producer.sortByCalibratedPt();
+}
+
+void ProducerSetup::setup( JetProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree * ) {
+
+    edm::EDGetTokenT<edm::View<pat::Jet> > jetToken = iC.consumes<edm::View<pat::Jet> >(
+               iConfig.getUntrackedParameter<edm::InputTag>("jetTag"));
+
+    producer.initialize( prefix( iConfig, "prefix_jet", "jet" ), jetToken, tree,
+                         minPt( iConfig, "jetMinPt" ), detail( iConfig, "jetDetailLevel" ),
+                         selection( iConfig ) );
+}
+
+void ProducerSetup::setup( FatJetProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree * ) {
+
+    edm::EDGetTokenT<edm::View<pat::Jet> > fjetToken = iC.consumes<edm::View<pat::Jet> >(
+                iConfig.getUntrackedParameter<edm::InputTag>("fatjetTag"));
+
+    producer.initialize( prefix( iConfig, "prefix_fjet", "fjet" ), fjetToken, tree,
+                         minPt( iConfig, "fjetMinPt" ), selection( iConfig ) );
+}
+
+void ProducerSetup::setup( METProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree * ) {
+
+    edm::EDGetTokenT<edm::View<pat::MET> > metToken = iC.consumes<edm::View<pat::MET> >(
+                iConfig.getUntrackedParameter<edm::InputTag>("metTag"));
+
+    producer.initialize( prefix( iConfig, "prefix_met", "met" ), metToken, tree );
+}
+
+void ProducerSetup::setup( METFilterProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree *infoTree ) {
+
+    edm::EDGetTokenT<edm::TriggerResults> metFilterToken = iC.consumes<edm::TriggerResults>(
+                iConfig.getUntrackedParameter<edm::InputTag>("metFilterTag"));
+
+    edm::EDGetTokenT<bool> BadChCandFilterToken =
+        iC.consumes<bool>(iConfig.getUntrackedParameter<edm::InputTag>("BadChargedCandidateFilter"));
+
+    edm::EDGetTokenT<bool> BadPFMuonFilterToken =
+        iC.consumes<bool>(iConfig.getUntrackedParameter<edm::InputTag>("BadPFMuonFilter"));
+
+    std::vector<std::string> filter_map =
+        iConfig.getUntrackedParameter<std::vector<std::string> >("metFilterMap");
+
+    producer.initialize( prefix( iConfig, "prefix_met_filter", "metFilter" ), metFilterToken,
+                         filter_map, tree, infoTree, bitmask( iConfig ) );
+
+    producer.addBadChargedCandidateFilterToken( BadChCandFilterToken );
+    producer.addBadPFMuonFilterToken( BadPFMuonFilterToken );
+}
+
+void ProducerSetup::setup( TriggerProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree *infoTree ) {
+
+    edm::EDGetTokenT<edm::TriggerResults> trigToken = iC.consumes<edm::TriggerResults>(
+                iConfig.getUntrackedParameter<edm::InputTag>("triggerTag"));
+
+    std::vector<std::string> trigger_map =
+        iConfig.getUntrackedParameter<std::vector<std::string> >("triggerMap");
+
+    edm::EDGetTokenT<pat::TriggerObjectStandAloneCollection> trigObjToken =
+                iC.consumes<pat::TriggerObjectStandAloneCollection> (
+                iConfig.getUntrackedParameter<edm::InputTag>("triggerObjTag"));
+
+    HLTObjLayout layout = HLTObjNested;
+    if( iConfig.exists("hltObjLayout") ) {
+        std::string name = iConfig.getUntrackedParameter<std::string>("hltObjLayout");
+        if(      name == "nested"  ) layout = HLTObjNested;
+        else if( name == "csr"     ) layout = HLTObjCSR;
+        else if( name == "bitmask" ) layout = HLTObjBitmask;
+        else {
+            throw cms::Exception("Configuration")
+            << "Unknown hltObjLayout " << name << ", use nested, csr or bitmask";
+        }
+    }
+
+    producer.initialize( prefix( iConfig, "prefix_trig", "passTrig" ), trigToken, trigObjToken,
+                         trigger_map, tree, infoTree, bitmask( iConfig ), layout );
+}
+
+void ProducerSetup::setup( GenParticleProducer & producer, const edm::ParameterSet & iConfig,
+                           edm::ConsumesCollector & iC, TTree *tree, TTree * ) {
+
+    edm::EDGetTokenT<std::vector<reco::GenParticle> > genToken = iC.consumes<std::vector<reco::GenParticle> >(
+               iConfig.getUntrackedParameter<edm::InputTag>("genParticleTag"));
+
+    producer.initialize( prefix( iConfig, "prefix_gen", "gen" ), genToken, tree,
+                         minPt( iConfig, "genMinPt" ), selection( iConfig ) );
+}
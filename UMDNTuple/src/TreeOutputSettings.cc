@@ -0,0 +1,116 @@
+#include <fnmatch.h>
+#include "UMDNTuple/UMDNTuple/interface/TreeOutputSettings.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "Compression.h"
+#include "TBranch.h"
+#include "TObjArray.h"
+
+TreeOutputSettings::TreeOutputSettings() {
+
+}
+
+TreeOutputSettings::TreeOutputSettings( const edm::ParameterSet & iConfig ) {
+
+    if( !iConfig.exists( "treeSettings" ) ) return;
+
+    std::vector<edm::ParameterSet> trees =
+        iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("treeSettings");
+
+    for( std::vector<edm::ParameterSet>::const_iterator itr = trees.begin();
+            itr != trees.end(); ++itr ) {
+
+        TreeSettings settings;
+        settings.compression = compression( *itr );
+        settings.basketSize = basketSize( *itr );
+        settings.autoFlush = 0;
+        settings.setAutoFlush = itr->exists( "autoFlush" );
+        if( settings.setAutoFlush ) {
+            // ROOT convention, negative values are in bytes
+            settings.autoFlush = itr->getUntrackedParameter<long long>("autoFlush");
+        }
+
+        if( itr->exists( "branchGroups" ) ) {
+            std::vector<edm::ParameterSet> groups =
+                itr->getUntrackedParameter<std::vector<edm::ParameterSet> >("branchGroups");
+            for( std::vector<edm::ParameterSet>::const_iterator gitr = groups.begin();
+                    gitr != groups.end(); ++gitr ) {
+                BranchGroup group;
+                group.patterns = gitr->getUntrackedParameter<std::vector<std::string> >("branches");
+                group.compression = compression( *gitr );
+                group.basketSize = basketSize( *gitr );
+                settings.groups.push_back( group );
+            }
+        }
+
+        _trees[itr->getUntrackedParameter<std::string>("tree")] = settings;
+    }
+}
+
+int TreeOutputSettings::compression( const edm::ParameterSet & iConfig ) {
+
+    // -1 leaves the compression unchanged
+    if( !iConfig.exists( "compressionAlgorithm" ) && !iConfig.exists( "compressionLevel" ) ) {
+        return -1;
+    }
+
+    std::string name = "ZLIB";
+    if( iConfig.exists( "compressionAlgorithm" ) ) {
+        name = iConfig.getUntrackedParameter<std::string>("compressionAlgorithm");
+    }
+    int level = 4;
+    if( iConfig.exists( "compressionLevel" ) ) {
+        level = iConfig.getUntrackedParameter<int>("compressionLevel");
+    }
+
+    ROOT::ECompressionAlgorithm algorithm;
+    if(      name == "ZLIB" ) algorithm = ROOT::kZLIB;
+    else if( name == "LZMA" ) algorithm = ROOT::kLZMA;
+    else if( name == "LZ4"  ) algorithm = ROOT::kLZ4;
+    else {
+        throw cms::Exception("Configuration")
+        << "Unknown compression algorithm " << name << ", use ZLIB, LZMA or LZ4";
+    }
+
+    return ROOT::CompressionSettings( algorithm, level );
+}
+
+int TreeOutputSettings::basketSize( const edm::ParameterSet & iConfig ) {
+
+    if( iConfig.exists( "basketSize" ) ) {
+        return iConfig.getUntrackedParameter<int>("basketSize");
+    }
+    return -1;
+}
+
+void TreeOutputSettings::apply( TTree *tree ) const {
+
+    std::map<std::string, TreeSettings>::const_iterator sitr = _trees.find( tree->GetName() );
+    if( sitr == _trees.end() ) return;
+
+    const TreeSettings & settings = sitr->second;
+
+    if( settings.setAutoFlush ) tree->SetAutoFlush( settings.autoFlush );
+
+    TObjArray *branches = tree->GetListOfBranches();
+    for( int i = 0; i < branches->GetEntriesFast(); ++i ) {
+
+        TBranch *branch = static_cast<TBranch*>( branches->UncheckedAt(i) );
+
+        int compression = settings.compression;
+        int basketSize = settings.basketSize;
+
+        for( std::vector<BranchGroup>::const_iterator gitr = settings.groups.begin();
+                gitr != settings.groups.end(); ++gitr ) {
+            for( std::vector<std::string>::const_iterator pitr = gitr->patterns.begin();
+                    pitr != gitr->patterns.end(); ++pitr ) {
+                if( fnmatch( pitr->c_str(), branch->GetName(), 0 ) != 0 ) continue;
+                if( gitr->compression >= 0 ) compression = gitr->compression;
+                if( gitr->basketSize > 0 ) basketSize = gitr->basketSize;
+                break;
+            }
+        }
+
+        if( compression >= 0 ) branch->SetCompressionSettings( compression );
+        if( basketSize > 0 ) branch->SetBasketSize( basketSize );
+    }
+}
@@ -1,9 +1,12 @@
 #include <bitset>
 #include <sstream>
+#include <algorithm>
 #include "UMDNTuple/UMDNTuple/interface/TriggerProducer.h"
 #include "FWCore/Framework/interface/Event.h"
 
 TriggerProducer::TriggerProducer(  )  :
+    _trigger_idx_map(0),
+    _trigger_path_ids(0),
     _passing_triggers(0),
     HLTObj_n(0),
     HLTObj_pt(0),
@@ -11,7 +14,11 @@ TriggerProducer::TriggerProducer(  )  :
     HLTObj_phi(0),
     HLTObj_e(0),
     HLTObj_passTriggers(0),
-    _prevRunNumber(0)
+    _hltObjLayout(HLTObjNested),
+    HLTObj_trigOffset(0),
+    HLTObjTrig_n(0),
+    HLTObjTrig_id(0),
+    _bitmask(false)
 {
 
 }
@@ -20,23 +27,30 @@ void TriggerProducer::initialize( const std::string &prefix,
             const edm::EDGetTokenT<edm::TriggerResults>& trigTok,
             const edm::EDGetTokenT<pat::TriggerObjectStandAloneCollection>& trigObjTok,
             const std::vector<std::string> &trigMap,
-            TTree *tree, TTree *infoTree) {
+            TTree *tree, TTree *infoTree, bool bitmask, HLTObjLayout layout) {
 
     _prefix = prefix;
     _trigToken = trigTok;
     _trigObjToken = trigObjTok;
     _infoTree = infoTree;
+    _bitmask = bitmask;
+    _hltObjLayout = layout;
 
-    tree->Branch("passedTriggers", &_passing_triggers );
+    _passing_triggers = &_passing_trigger_ids;
+    if( !_bitmask ) {
+        tree->Branch("passedTriggers", &_passing_triggers );
+    }
 
     tree->Branch("HLTObj_n"  , &HLTObj_n, "HLTObj_n/I");
     tree->Branch("HLTObj_pt" , &HLTObj_pt );
     tree->Branch("HLTObj_eta", &HLTObj_eta );
     tree->Branch("HLTObj_phi", &HLTObj_phi );
     tree->Branch("HLTObj_e"  , &HLTObj_e );
-    tree->Branch("HLTObj_passTriggers"  , &HLTObj_passTriggers );
 
-    _trigger_idx_map.clear();
+    _trigger_idx_cache.clear();
+    _trigger_idx_map = 0;
+    _trigger_path_cache.clear();
+    _trigger_path_ids = 0;
     _trigger_map.clear();
        
     // parse trigger map parameter from CMSSW config 
@@ -56,10 +70,47 @@ void TriggerProducer::initialize( const std::string &prefix,
 
     }
 
+    // enough 64 bit words for the largest trigger id
+    int max_idx = 0;
+    for( std::map<std::string, int>::const_iterator itr = _trigger_map.begin();
+            itr != _trigger_map.end(); ++itr ) {
+        max_idx = std::max( max_idx, itr->second );
+    }
+    unsigned nwords = max_idx/64 + 1;
+
+    if( _hltObjLayout == HLTObjNested ) {
+        tree->Branch("HLTObj_passTriggers"  , &HLTObj_passTriggers );
+    }
+    if( _hltObjLayout == HLTObjCSR ) {
+        // ids of object i start at HLTObj_trigOffset[i] and
+        // end at the next offset, or at HLTObjTrig_n
+        tree->Branch("HLTObj_trigOffset", &HLTObj_trigOffset );
+        tree->Branch("HLTObjTrig_n"  , &HLTObjTrig_n, "HLTObjTrig_n/I");
+        tree->Branch("HLTObjTrig_id" , &HLTObjTrig_id );
+    }
+    if( _hltObjLayout == HLTObjBitmask ) {
+        // the pointers are set before booking, the
+        // vector must not be resized afterwards
+        HLTObj_trigBits.assign( nwords, 0 );
+        for( unsigned i = 0; i < nwords; ++i ) {
+            std::stringstream name;
+            name << "HLTObj_trigBits" << i;
+            tree->Branch( name.str().c_str(), &HLTObj_trigBits[i] );
+        }
+    }
+
+    if( _bitmask ) {
+        _triggerBits.assign( nwords, 0 );
+
+        std::stringstream leaflist;
+        leaflist << "passedTriggerBits[" << _triggerBits.size() << "]/l";
+        tree->Branch("passedTriggerBits", &_triggerBits[0], leaflist.str().c_str() );
+    }
+
 }
 
 
-void TriggerProducer::produce(const edm::Event &iEvent ) {
+void TriggerProducer::produce(const edm::Event &iEvent, const EventContext & ) {
 
     edm::Handle<edm::TriggerResults> triggers;
     iEvent.getByToken(_trigToken,triggers);
@@ -80,81 +131,142 @@ void TriggerProducer::produce(const edm::Event &iEvent ) {
     HLTObj_eta->clear();
     HLTObj_phi->clear();
     HLTObj_e->clear();
-    HLTObj_passTriggers->clear();
+    if( _hltObjLayout == HLTObjNested ) {
+        HLTObj_passTriggers->clear();
+    }
+    if( _hltObjLayout == HLTObjCSR ) {
+        HLTObj_trigOffset->clear();
+        HLTObjTrig_n = 0;
+        HLTObjTrig_id->clear();
+    }
+    if( _hltObjLayout == HLTObjBitmask ) {
+        for( unsigned i = 0; i < HLTObj_trigBits.size(); ++i ) {
+            HLTObj_trigBits[i]->clear();
+        }
+    }
 
     const edm::TriggerNames trigNames( iEvent.triggerNames( *triggers ) );
 
-    int runNumber     = iEvent.id().run();
+    // the index map only changes with the trigger menu.  Keep
+    // one per menu in case the menus alternate between files
+    const edm::ParameterSetID & menu = trigNames.parameterSetID();
+
+    if( !_trigger_idx_map || menu != _trigger_menu ) {
 
-    if( _trigger_idx_map.size() == 0 || ( runNumber != _prevRunNumber ) ) {
+        std::map<edm::ParameterSetID, std::vector<std::pair<int, int> > >::iterator citr =
+            _trigger_idx_cache.find( menu );
 
-        _trigger_idx_map.clear();
+        if( citr == _trigger_idx_cache.end() ) {
 
-        for (unsigned i = 0; i < trigNames.size(); i++) {
+            std::vector<std::pair<int, int> > & idx_map = _trigger_idx_cache[menu];
+            std::vector<int> & path_ids = _trigger_path_cache[menu];
+            path_ids.assign( trigNames.size(), -1 );
 
-            std::string trigname = trigNames.triggerName(i);
+            for (unsigned i = 0; i < trigNames.size(); i++) {
 
-            std::string::size_type version_pos = trigname.find_last_of("_");
+                std::string trigname = trigNames.triggerName(i);
 
-            std::string trigname_mod = trigname.substr( 0, version_pos );
-	    //std::cout<< std::setw(4)<<i<<" trig name: "<< trigname <<" trig name mod: "<<trigname_mod<<std::endl;
-	    //std::cout<< std::setw(3)<<i<<" "<<trigname_mod<<std::endl;
+                std::string::size_type version_pos = trigname.find_last_of("_");
 
-            std::map<std::string, int>::const_iterator mitr = _trigger_map.find(trigname_mod);
+                std::string trigname_mod = trigname.substr( 0, version_pos );
+	        //std::cout<< std::setw(4)<<i<<" trig name: "<< trigname <<" trig name mod: "<<trigname_mod<<std::endl;
+	        //std::cout<< std::setw(3)<<i<<" "<<trigname_mod<<std::endl;
 
-            if( mitr != _trigger_map.end() ) {
-	//	std::cout<< "pushback: " << mitr->first << " " << mitr->second << std::endl;
-                _trigger_idx_map.push_back( std::make_pair(i, mitr->second) );
+                std::map<std::string, int>::const_iterator mitr = _trigger_map.find(trigname_mod);
+
+                if( mitr != _trigger_map.end() ) {
+	    //	std::cout<< "pushback: " << mitr->first << " " << mitr->second << std::endl;
+                    idx_map.push_back( std::make_pair(i, mitr->second) );
+                    // trigger objects only use "HLT" paths
+                    if( trigname.compare( 0, 4, "HLT_" ) == 0 ) {
+                        path_ids[i] = mitr->second;
+                    }
+                }
             }
+            citr = _trigger_idx_cache.find( menu );
         }
+
+        _trigger_idx_map = &citr->second;
+        _trigger_path_ids = &_trigger_path_cache[menu];
+        _trigger_menu = menu;
     }
 
-    for( std::vector<std::pair<int,int> >::const_iterator mitr = _trigger_idx_map.begin();
-            mitr != _trigger_idx_map.end(); ++mitr ) {
+    for( std::vector<std::pair<int,int> >::const_iterator mitr = _trigger_idx_map->begin();
+            mitr != _trigger_idx_map->end(); ++mitr ) {
         if( triggers->accept( mitr->first ) ) {
 	 //   std::cout<< "trigger: " << mitr->first << " " << mitr->second << " accepted"<< std::endl;
             _passing_triggers->push_back( mitr->second );
 	}
     }
-    for (unsigned j=0; j < triggerObjects->size();++j){
-        pat::TriggerObjectStandAlone obj = triggerObjects->at(j);
-    
-        obj.unpackPathNames(trigNames);
-        
-        std::vector<std::string> pathNamesLast = obj.pathNames(true);
 
-        std::vector<int> passed_trigs;
-
-        for( unsigned i = 0; i < pathNamesLast.size(); ++i ) {
-            std::string pathname = pathNamesLast[i];
-            if( pathname.substr(0,4) != "HLT_" ) continue; // ignore non "HLT" triggers
+    if( _bitmask ) {
+        std::fill( _triggerBits.begin(), _triggerBits.end(), 0 );
+        for( std::vector<int>::const_iterator itr = _passing_triggers->begin();
+                itr != _passing_triggers->end(); ++itr ) {
+            if( *itr < 0 ) continue;
+            _triggerBits[*itr/64] |= ( ULong64_t(1) << ( *itr % 64 ) );
+        }
+    }
 
-            std::string::size_type version_pos = pathname.find_last_of("_");
+    for( pat::TriggerObjectStandAloneCollection::const_iterator oitr = triggerObjects->begin();
+            oitr != triggerObjects->end(); ++oitr ) {
 
-            std::string pathname_mod = pathname.substr(0, version_pos);
+        _passed_trigs.clear();
 
-            std::map<std::string, int>::const_iterator mitr = 
-                _trigger_map.find(pathname_mod);
+        // unpacking the path names needs a non-const object.
+        // Assigning to the scratch object reuses its buffers
+        _trigObj = *oitr;
+        _trigObj.unpackPathNames(trigNames);
 
-            if( mitr != _trigger_map.end() ) {
-                passed_trigs.push_back( mitr->second );
-            }
+        // the paths for which the object passed the last filter,
+        // mapped to trigger ids through the table of this menu
+        const std::vector<std::string> pathNamesLast = _trigObj.pathNames(true);
+        for( std::vector<std::string>::const_iterator pitr = pathNamesLast.begin();
+                pitr != pathNamesLast.end(); ++pitr ) {
+            addPath( trigNames.triggerIndex( *pitr ) );
         }
 
-        if( passed_trigs.size() > 0 ) {
+        if( _passed_trigs.size() > 0 ) {
 
             HLTObj_n++;
-            HLTObj_pt->push_back( obj.pt() );
-            HLTObj_eta->push_back( obj.eta() );
-            HLTObj_phi->push_back( obj.phi() );
-            HLTObj_e->push_back( obj.energy() );
-            HLTObj_passTriggers->push_back(passed_trigs);
+            HLTObj_pt->push_back( _trigObj.pt() );
+            HLTObj_eta->push_back( _trigObj.eta() );
+            HLTObj_phi->push_back( _trigObj.phi() );
+            HLTObj_e->push_back( _trigObj.energy() );
+            if( _hltObjLayout == HLTObjNested ) {
+                HLTObj_passTriggers->push_back(_passed_trigs);
+            }
+            if( _hltObjLayout == HLTObjCSR ) {
+                HLTObj_trigOffset->push_back( HLTObjTrig_n );
+                HLTObjTrig_id->insert( HLTObjTrig_id->end(), _passed_trigs.begin(), _passed_trigs.end() );
+                HLTObjTrig_n += _passed_trigs.size();
+            }
+            if( _hltObjLayout == HLTObjBitmask ) {
+                for( unsigned i = 0; i < HLTObj_trigBits.size(); ++i ) {
+                    HLTObj_trigBits[i]->push_back( 0 );
+                }
+                for( std::vector<int>::const_iterator itr = _passed_trigs.begin();
+                        itr != _passed_trigs.end(); ++itr ) {
+                    if( *itr < 0 ) continue;
+                    HLTObj_trigBits[*itr/64]->back() |= ( ULong64_t(1) << ( *itr % 64 ) );
+                }
+            }
         }
 
     }
 
 }
 
+void TriggerProducer::addPath( unsigned pathIndex ) {
+
+    // indices past the menu are other paths or names
+    // that are not in the menu
+    if( pathIndex >= _trigger_path_ids->size() ) return;
+
+    int id = (*_trigger_path_ids)[pathIndex];
+    if( id >= 0 ) _passed_trigs.push_back( id );
+}
+
 void TriggerProducer::endRun() {
 
     int trigger_ids = 0;
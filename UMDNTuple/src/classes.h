@@ -0,0 +1,2 @@
+#include "DataFormats/Common/interface/Wrapper.h"
+#include "UMDNTuple/UMDNTuple/interface/UMDTable.h"